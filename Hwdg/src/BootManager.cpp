@@ -17,16 +17,24 @@
 #define BOOT_SETTINGS                 ((uint_least8_t)3)
 #define REBOOT_TIMEOUT_SETTINGS       ((uint_least8_t)3)
 #define BOOT_PULSE_TIMEOUT            ((uint_fast16_t)3000)
-#define MID_PULSE_TIMEOUT             ((uint_fast16_t)2000)
-#define CMD_PULSE_TIMEOUT             ((uint_fast16_t)1000)
 #define INITIAL                       ((uint_fast16_t)0)
+// Reset counters check period, ms
+#define PERSIST_PERIOD                ((uint16_t)1000U)
 
-BootManager::BootManager(ResetController& rctr, SettingsManager& smgr) :
-	counter(INITIAL),
+BootManager::BootManager(ResetController& rctr, SettingsManager& smgr, FrequencyScaler& scaler) :
 	rctr(rctr),
-	smgr(smgr)
+	smgr(smgr),
+	scaler(scaler),
+	savedSoft(INITIAL),
+	savedHard(INITIAL),
+	persistTicks(INITIAL),
+	persistPending(INITIAL)
 {
-
+#ifndef __AVR__
+	// Timer interrupt only marks counters to be checked, EEPROM write
+	// takes several ms and would stall every timer subscriber.
+	rctr.GetRebooter().GetTimer().SubscribeOnElapse(*this);
+#endif
 }
 
 void BootManager::ProceedBoot()
@@ -34,6 +42,11 @@ void BootManager::ProceedBoot()
 	uint8_t settings[4];
 	*reinterpret_cast<uint32_t*>(settings) = smgr.ObtainUserSettings();
 
+	// Resets are counted since factory reset regardless of startup settings.
+	smgr.ObtainResetCounters(savedSoft, savedHard);
+	rctr.ImportResetCounters(savedSoft, savedHard);
+	CountResetCauses();
+
 	// If we apply user settings at startupp we must config reset controller,
 	// event manager and LED controller.
 	if (settings[3] & APPLY_SETTINGS_AT_STARTUP)
@@ -47,47 +60,80 @@ void BootManager::ProceedBoot()
 		rctr.SetHardResetAttempts(settings[2] >> 2);
 
 		if (settings[2] & 1) rctr.EnableHardReset();
-		if (settings[3] & EVENTS_ENABLED) rctr.EnableEvents();
+		if (settings[0] & AUTO_REARM_ENABLED) rctr.EnableAutoRearm();
+		if (settings[3] & EVENTS_ENABLED)
+		{
+			uint8_t stream, period;
+			smgr.ObtainEventStream(stream, period);
+			stream ? rctr.SetEventStream(period) : rctr.EnableEvents();
+		}
+
+		uint8_t program[ESCALATION_SIZE];
+		smgr.ObtainEscalation(program);
+		for (uint8_t i = 0; i < ESCALATION_SIZE / 2; i++)
+			rctr.SetEscalationStage(i, program[i * 2], program[i * 2 + 1]);
+
+		uint8_t adaptive[ADAPTIVE_REBOOT_SIZE];
+		smgr.ObtainAdaptiveReboot(adaptive);
+		rctr.ImportAdaptiveReboot(adaptive);
 	}
 	else
 	{
 		rctr.GetLedController().Enable();
 	}
 
-	// Subscribe on timer to get 1 ms timebase.
-	rctr.GetRebooter().GetTimer().SubscribeOnElapse(*this);
-
-	// If we're going to send any pulse we need to wait few seconds before send pulse.
-	if (settings[3] & RST_PULSE_ENABLED || settings[3] & PWR_PULSE_ENABLED)
-		while (counter < BOOT_PULSE_TIMEOUT)
-			;
-
-	// Send PWR pulse
-	counter = INITIAL;
+	// Pulses are queued few seconds apart from each other,
+	// so boot proceeds without waiting for them.
 	if (settings[3] & PWR_PULSE_ENABLED)
-		while (rctr.GetRebooter().PwrPulse() == Busy)
-			if (counter > CMD_PULSE_TIMEOUT) return;
+		rctr.GetRebooter().PwrPulse(BOOT_PULSE_TIMEOUT);
+	if (settings[3] & RST_PULSE_ENABLED)
+		rctr.GetRebooter().SoftReset(BOOT_PULSE_TIMEOUT);
+}
 
-	// If we send pulse both PWR and RST we need to wait few seconds between pulses.
-	if (settings[3] & RST_PULSE_ENABLED && settings[3] & PWR_PULSE_ENABLED)
-		while (counter < BOOT_PULSE_TIMEOUT)
-			;
+void BootManager::CountResetCauses()
+{
+	uint16_t counters[CAUSES_SIZE / 2];
+	smgr.ObtainResetCauses(counters);
 
-	// Send RST pulse
-	counter = INITIAL;
-	if (settings[3] & RST_PULSE_ENABLED)
-		while (rctr.GetRebooter().SoftReset() == Busy)
-			if (counter > CMD_PULSE_TIMEOUT) return;
+	// Counters saturate rather than wrap around to zero.
+	const uint8_t cause = ChipReset::GetResetCause();
+	for (uint8_t i = 0; i < CAUSES_SIZE / 2; i++)
+		if (cause & 1U << i && counters[i] != 0xFFFF) counters[i]++;
 
-	// Unsubscribe on timer elapse as we no longer need time base.
-	rctr.GetRebooter().GetTimer().UnsubscribeOnElapse(*this);
+	smgr.SaveResetCauses(counters);
 }
 
-BootManager::~BootManager()
+void BootManager::PersistResetCounters()
 {
+#ifndef __AVR__
+	if (!persistPending) return;
+	persistPending = INITIAL;
+#endif
+
+	ResetSnapshot snapshot;
+	rctr.GetSnapshot(snapshot);
+	if (snapshot.totalSoftResets == savedSoft && snapshot.totalHardResets == savedHard)
+		return;
+
+	// Keep old values on failure so the next call retries.
+	scaler.Boost();
+	if (smgr.SaveResetCounters(snapshot.totalSoftResets, snapshot.totalHardResets))
+	{
+		savedSoft = snapshot.totalSoftResets;
+		savedHard = snapshot.totalHardResets;
+	}
 }
 
 void BootManager::Callback(uint8_t data)
 {
-	counter++;
+	if (++persistTicks < PERSIST_PERIOD) return;
+	persistTicks = INITIAL;
+	persistPending = 1;
+}
+
+BootManager::~BootManager()
+{
+#ifndef __AVR__
+	rctr.GetRebooter().GetTimer().UnsubscribeOnElapse(*this);
+#endif
 }
@@ -15,6 +15,8 @@
 #pragma once
 #include "ResetController.h"
 #include "SettingsManager.h"
+#include "ChipReset.h"
+#include "FrequencyScaler.h"
 
 class BootManager : ISubscriber
 {
@@ -23,21 +25,36 @@ public:
 	 * \brief Create instance of boot manager.
 	 * \param rctr Reset controller.
 	 * \param smgr Settings manager.
+	 * \param scaler Frequency scaler boosted around EEPROM writes.
 	 */
-	BootManager(ResetController& rctr, SettingsManager& smgr);
+	BootManager(ResetController& rctr, SettingsManager& smgr, FrequencyScaler& scaler);
 
 	/**
 	 * \brief Proceed boot.
 	 */
 	_virtual void ProceedBoot();
 
+	/**
+	 * \brief Save resets counted since factory reset if they changed.
+	 * \remarks Call it from main loop. On STM8 counters are checked once a second,
+	 * when timer interrupt marks them pending. Settings command handled in UART
+	 * interrupt in the middle of the write locks EEPROM again, the write then
+	 * fails verification and is retried on the next check.
+	 */
+	_virtual void PersistResetCounters();
+
 	/**
 	* \brief Dispose Reset controller.
 	*/
 	~BootManager();
 private:
 	void Callback(uint8_t data) _override;
-	volatile uint_fast16_t counter;
+	void CountResetCauses();
 	ResetController& rctr;
 	SettingsManager& smgr;
+	FrequencyScaler& scaler;
+	uint32_t savedSoft;
+	uint32_t savedHard;
+	uint16_t persistTicks;
+	volatile uint8_t persistPending;
 };
@@ -22,6 +22,21 @@
 #define CHIP_RESET_PIN   ((uint8_t)10U)
 #endif
 
+// Reset cause hasn't been read from hardware yet
+#define NOT_READ         ((uint8_t)0x00U)
+
+uint8_t ChipReset::cause = NOT_READ;
+
+#ifdef _M_IX86
+static uint8_t simulatedFlags = NOT_READ;
+
+void ChipReset::SimulateResetFlags(uint8_t mask)
+{
+	simulatedFlags = mask;
+	cause = NOT_READ;
+}
+#endif
+
 void ChipReset::ResetImmediately()
 {
 #ifdef __ICCSTM8__
@@ -31,3 +46,35 @@ void ChipReset::ResetImmediately()
 	pinMode(CHIP_RESET_PIN, OUTPUT);
 #endif
 }
+
+uint8_t ChipReset::GetResetCause()
+{
+	// Power on is reported when no flag is set, so a read mask is never zero.
+	if (cause != NOT_READ) return cause;
+
+#ifdef __ICCSTM8__
+	// Flags are cleared by writing 1.
+	const uint8_t flags = RST->SR;
+	RST->SR = flags;
+	if (flags & RST_SR_WWDGF) cause |= 1U << CauseWindowWatchdog;
+	if (flags & RST_SR_IWDGF) cause |= 1U << CauseIndependentWatchdog;
+	if (flags & RST_SR_ILLOPF) cause |= 1U << CauseIllegalOpcode;
+	if (flags & RST_SR_SWIMF) cause |= 1U << CauseDebugger;
+	if (flags & RST_SR_EMCF) cause |= 1U << CauseEmc;
+#endif
+#ifdef __AVR__
+	// Bootloaders that clear MCUSR themselves make every reset look like power on.
+	const uint8_t flags = MCUSR;
+	MCUSR = 0;
+	if (flags & _BV(PORF)) cause |= 1U << CausePowerOn;
+	if (flags & _BV(EXTRF)) cause |= 1U << CauseExternal;
+	if (flags & _BV(BORF)) cause |= 1U << CauseBrownOut;
+	if (flags & _BV(WDRF)) cause |= 1U << CauseIndependentWatchdog;
+#endif
+#ifdef _M_IX86
+	cause = simulatedFlags;
+#endif
+
+	if (cause == NOT_READ) cause = 1U << CausePowerOn;
+	return cause;
+}
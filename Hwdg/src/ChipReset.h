@@ -13,6 +13,30 @@
 // limitations under the License.
 
 #pragma once
+#include <stdint.h>
+
+/**
+ * \brief Chip reset cause, each cause is a bit in the mask GetResetCause() returns.
+ */
+enum ResetCause
+{
+	// Power on, on STM8 also NRST pin (no flag is set)
+	CausePowerOn = 0,
+	// Window watchdog, ResetImmediately() on STM8
+	CauseWindowWatchdog = 1,
+	// Independent watchdog (AVR watchdog)
+	CauseIndependentWatchdog = 2,
+	// Illegal opcode
+	CauseIllegalOpcode = 3,
+	// SWIM debugger
+	CauseDebugger = 4,
+	// Electromagnetic disturbance
+	CauseEmc = 5,
+	// External reset pin, ResetImmediately() on AVR
+	CauseExternal = 6,
+	// Brown-out detector
+	CauseBrownOut = 7
+};
 
 /**
 * \brief Represents microcontroller reset function.
@@ -25,4 +49,20 @@ public:
 	 * \brief Reset chip immediately.
 	 */
 	static void ResetImmediately();
+
+	/**
+	 * \brief Get causes of the last chip reset as ResetCause bit mask.
+	 * \remarks The first call reads and clears hardware reset flags, so the
+	 * next reset isn't mixed up with this one. Subsequent calls return the same mask.
+	 */
+	static uint8_t GetResetCause();
+
+#ifdef _M_IX86
+	/**
+	 * \brief Set reset flags host builds report as if read from hardware.
+	 */
+	static void SimulateResetFlags(uint8_t mask);
+#endif
+private:
+	static uint8_t cause;
 };
@@ -36,6 +36,8 @@ CpuFreq Clock::GetCpuFreq()
 void Clock::SetCpuFreq(CpuFreq freq)
 {
 #ifdef __ICCSTM8__
+	// CPU divider leaves master clock at MASTER_FREQ, so Timer and Uart
+	// keep their rates and a byte being received isn't corrupted.
 	curentFreq = freq;
 	switch (freq)
 	{
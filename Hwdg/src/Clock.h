@@ -14,6 +14,9 @@
 
 #pragma once
 
+// Master clock frequency, HSI runs undivided and only CPU clock is scaled
+#define MASTER_FREQ ((uint32_t)16000000U)
+
 enum CpuFreq
 {
 	Freq2Mhz = 2000000U,
@@ -16,10 +16,18 @@
 #include "Crc.h"
 #include "ChipReset.h"
 
-CommandManager::CommandManager(Uart& uart, ResetController& rstController, SettingsManager& btmgr) :
+CommandManager::CommandManager(Uart& uart, ResetController& rstController, SettingsManager& btmgr,
+	FrequencyScaler& scaler) :
 	uart(uart),
 	resetController(rstController),
-	settingsManager(btmgr)
+	settingsManager(btmgr),
+	scaler(scaler),
+	command(0),
+	argsCount(0),
+	argsReceived(0),
+	tag(0),
+	tagged(false),
+	lastByteTime(0)
 {
 	CommandManager::uart.SubscribeOnByteReceived(*this);
 }
@@ -31,6 +39,49 @@ CommandManager::~CommandManager()
 
 inline void CommandManager::Callback(uint8_t data)
 {
+	// Response and EEPROM writes run at high frequency.
+	scaler.Boost();
+
+	// Unfinished command is dropped after a pause, so a lost argument
+	// byte doesn't turn the following commands into arguments.
+	const uint16_t now = Timer::GetTicks();
+	if (uint16_t(now - lastByteTime) > ARGS_TIMEOUT)
+	{
+		argsCount = 0;
+		tagged = false;
+	}
+	lastByteTime = now;
+
+	// Multibyte command: collect all arguments before execution.
+	if (argsCount)
+	{
+		args[argsReceived++] = data;
+		if (argsReceived < argsCount) return;
+		argsCount = 0;
+		data = command;
+	}
+	else if ((argsCount = GetArgsCount(data)) != 0)
+	{
+		command = data;
+		argsReceived = 0;
+		return;
+	}
+
+	// Tag applies to the next command only: its response follows
+	// TaggedResponse marker and the tag, so host can match it.
+	if (data == 0x0D) // TagNextCommand command
+	{
+		tag = args[0];
+		tagged = true;
+		return;
+	}
+	if (tagged)
+	{
+		tagged = false;
+		uart.SendByte(TaggedResponse);
+		uart.SendByte(tag);
+	}
+
 	data == 0xFB // Ping command
 		? uart.SendByte(resetController.Ping())
 		: data == 0xF8 // IsAlive command
@@ -57,6 +108,28 @@ inline void CommandManager::Callback(uint8_t data)
 		? uart.SendByte(resetController.EnableEvents())
 		: data == 0x03 // DisableEvents command
 		? uart.SendByte(resetController.DisableEvents())
+		: data == 0x04 // SetEscalationStage command
+		? uart.SendByte(resetController.SetEscalationStage(args[0], args[1], args[2]))
+		: data == 0x05 // GetEscalation command
+		? GetEscalation()
+		: data == 0x06 // EnableAutoRearm command
+		? uart.SendByte(resetController.EnableAutoRearm())
+		: data == 0x07 // DisableAutoRearm command
+		? uart.SendByte(resetController.DisableAutoRearm())
+		: data == 0x08 // SetAdaptiveReboot command
+		? uart.SendByte(resetController.SetAdaptiveReboot(args[0], args[1], args[2]))
+		: data == 0x09 // GetExtendedStatus command
+		? GetExtendedStatus()
+		: data == 0x0A // SetActivityTimeout command
+		? uart.SendByte(resetController.SetActivityTimeout(args[0]))
+		: data == 0x0B // SetEventStream command
+		? uart.SendByte(resetController.SetEventStream(args[0]))
+		: data == 0x0C // GetResetCauses command
+		? GetResetCauses()
+		: data == 0x0E // SetBusAddress command
+		? uart.SendByte(SetBusAddress(args[0]))
+		: data == 0x0F // GetPulseStats command
+		? GetPulseStats()
 
 		: data == 0x3F // RstPulseOnStartupDisable command
 		? uart.SendByte(settingsManager.RstPulseOnStartupDisable())
@@ -90,6 +163,23 @@ inline void CommandManager::Callback(uint8_t data)
 		: uart.SendByte(UnknownCommand);
 }
 
+inline uint8_t CommandManager::GetArgsCount(uint8_t cmd)
+{
+	return cmd == 0x04 // SetEscalationStage command
+		? 3
+		: cmd == 0x08 // SetAdaptiveReboot command
+		? 3
+		: cmd == 0x0A // SetActivityTimeout command
+		? 1
+		: cmd == 0x0B // SetEventStream command
+		? 1
+		: cmd == 0x0D // TagNextCommand command
+		? 1
+		: cmd == 0x0E // SetBusAddress command
+		? 1
+		: 0;
+}
+
 inline void CommandManager::GetStatus()
 {
 	uint8_t buffer[5];
@@ -125,12 +215,121 @@ Response CommandManager::SaveCurrentSettings()
 		? buffer[3] |= EVENTS_ENABLED
 		: buffer[3] &= ~EVENTS_ENABLED;
 
+	// Event stream mode and its heartbeat don't fit settings bytes.
+	uint8_t period;
+	const uint8_t stream = resetController.IsEventStream(period);
+
+	// Get adaptive reboot settings along with learned boot statistics.
+	uint8_t adaptive[ADAPTIVE_REBOOT_SIZE];
+	resetController.ExportAdaptiveReboot(adaptive);
+
 	// Save all settings we got earlier
-	return settingsManager.SaveUserSettings(*reinterpret_cast<uint32_t*>(buffer))
+	return settingsManager.SaveUserSettings(*reinterpret_cast<uint32_t*>(buffer)) &&
+		settingsManager.SaveEscalation(resetController.GetEscalation()) &&
+		settingsManager.SaveAdaptiveReboot(adaptive) &&
+		settingsManager.SaveEventStream(stream, period)
 		? SaveCurrentSettingsOk
 		: SaveSettingsError;
 }
 
+inline Response CommandManager::SetBusAddress(uint8_t address)
+{
+	// Broadcast address is accepted by every board, it can't be own one.
+	// New address takes effect after reboot, so the response reaches the host.
+	if (address == BUS_BROADCAST) return InvalidArgument;
+	return settingsManager.SaveBusAddress(address)
+		? SetBusAddressOk
+		: SaveSettingsError;
+}
+
+inline void CommandManager::GetEscalation()
+{
+	uint8_t buffer[ESCALATION_SIZE + 1];
+	const uint8_t* program = resetController.GetEscalation();
+	for (uint8_t i = 0; i < ESCALATION_SIZE; i++)
+		buffer[i] = program[i];
+
+	buffer[ESCALATION_SIZE] = CrcCalculator::GetCrc7(buffer, ESCALATION_SIZE);
+	uart.SendData(buffer, ESCALATION_SIZE + 1);
+}
+
+inline void CommandManager::GetExtendedStatus()
+{
+	ResetSnapshot snapshot;
+	resetController.GetSnapshot(snapshot);
+
+	// Frame starts with payload length so that fields appended
+	// later don't break hosts that know only the leading ones.
+	uint8_t buffer[EXTENDED_STATUS_SIZE + 2];
+	uint8_t length = 1;
+	length = PutUint32(buffer, length, snapshot.bootDuration);
+	length = PutUint32(buffer, length, snapshot.bootMean);
+	length = PutUint32(buffer, length, snapshot.bootDeviation);
+	length = PutUint32(buffer, length, snapshot.rebootTimeout);
+	buffer[length++] = snapshot.bootSamples;
+	buffer[length++] = resetController.GetAdaptiveFactor();
+	buffer[length++] = snapshot.activityEdges;
+	length = PutUint32(buffer, length, snapshot.uptime);
+	length = PutUint32(buffer, length, snapshot.pings);
+	length = PutUint16(buffer, length, snapshot.softResets);
+	length = PutUint16(buffer, length, snapshot.hardResets);
+	length = PutUint32(buffer, length, snapshot.totalSoftResets);
+	length = PutUint32(buffer, length, snapshot.totalHardResets);
+	length = PutUint32(buffer, length, snapshot.sincePing);
+	length = PutUint32(buffer, length, snapshot.untilAction);
+	buffer[0] = length - 1;
+
+	buffer[length] = CrcCalculator::GetCrc7(buffer, length);
+	uart.SendData(buffer, length + 1);
+}
+
+inline void CommandManager::GetResetCauses()
+{
+	// Causes of the current boot followed by counters of each cause.
+	uint16_t counters[CAUSES_SIZE / 2];
+	settingsManager.ObtainResetCauses(counters);
+
+	uint8_t buffer[CAUSES_SIZE + 2];
+	uint8_t length = 0;
+	buffer[length++] = ChipReset::GetResetCause();
+	for (uint8_t i = 0; i < CAUSES_SIZE / 2; i++)
+		length = PutUint16(buffer, length, counters[i]);
+
+	buffer[length] = CrcCalculator::GetCrc7(buffer, length);
+	uart.SendData(buffer, length + 1);
+}
+
+inline void CommandManager::GetPulseStats()
+{
+	PulseStats stats;
+	resetController.GetRebooter().GetPulseStats(stats);
+
+	uint8_t buffer[sizeof stats + 1];
+	uint8_t length = 0;
+	length = PutUint16(buffer, length, stats.pulses);
+	length = PutUint16(buffer, length, stats.failures);
+	length = PutUint16(buffer, length, stats.lastRiseTime);
+	length = PutUint16(buffer, length, stats.lastDriveTime);
+
+	buffer[length] = CrcCalculator::GetCrc7(buffer, length);
+	uart.SendData(buffer, length + 1);
+}
+
+inline uint8_t CommandManager::PutUint32(uint8_t* buffer, uint8_t offset, uint32_t value)
+{
+	// Most significant byte first regardless of platform endianness.
+	for (int8_t shift = 24; shift >= 0; shift -= 8)
+		buffer[offset++] = (uint8_t)(value >> shift);
+	return offset;
+}
+
+inline uint8_t CommandManager::PutUint16(uint8_t* buffer, uint8_t offset, uint16_t value)
+{
+	buffer[offset++] = (uint8_t)(value >> 8);
+	buffer[offset++] = (uint8_t)value;
+	return offset;
+}
+
 void CommandManager::RestoreFactory()
 {
 	settingsManager.RestoreFactory();
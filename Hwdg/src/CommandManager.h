@@ -15,6 +15,20 @@
 #pragma once
 #include "ResetController.h"
 #include "SettingsManager.h"
+#include "FrequencyScaler.h"
+
+#ifndef MAX_COMMAND_ARGS
+// Maximum arguments count multibyte command may have
+#define MAX_COMMAND_ARGS 3
+#endif
+
+#ifndef ARGS_TIMEOUT
+// Greatest gap between bytes of multibyte command, ms
+#define ARGS_TIMEOUT ((uint16_t)100U)
+#endif
+
+// Extended status payload size, bytes
+#define EXTENDED_STATUS_SIZE ((uint8_t)47U)
 
 class CommandManager : ISubscriber
 {
@@ -22,8 +36,9 @@ public:
 	/**
 	 * \brief Create instance of command manager.
 	 * \param rctr Reset controller.
+	 * \param scaler Frequency scaler boosted on every received byte.
 	 */
-	CommandManager(Uart& uart, ResetController& rctr, SettingsManager& btmgr);
+	CommandManager(Uart& uart, ResetController& rctr, SettingsManager& btmgr, FrequencyScaler& scaler);
 
 	/**
 	 * \brief Dispose Reset controller.
@@ -39,8 +54,24 @@ private:
 	Uart& uart;
 	ResetController& resetController;
 	SettingsManager& settingsManager;
+	FrequencyScaler& scaler;
+	uint8_t command;
+	uint8_t argsCount;
+	uint8_t argsReceived;
+	uint8_t args[MAX_COMMAND_ARGS];
+	uint8_t tag;
+	bool tagged;
+	uint16_t lastByteTime;
 
+	inline uint8_t GetArgsCount(uint8_t cmd);
 	inline void GetStatus();
+	inline void GetEscalation();
+	inline void GetExtendedStatus();
+	inline void GetResetCauses();
+	inline Response SetBusAddress(uint8_t address);
+	inline void GetPulseStats();
+	inline uint8_t PutUint32(uint8_t* buffer, uint8_t offset, uint32_t value);
+	inline uint8_t PutUint16(uint8_t* buffer, uint8_t offset, uint16_t value);
 	inline Response SaveCurrentSettings();
 	inline void RestoreFactory();
 };
@@ -18,7 +18,17 @@
 class CrcCalculator
 {
 public:
+	/**
+	 * \brief Calculate CRC7 checksum with the engine selected by CRC_ENGINE.
+	 * \param buffer Buffer pointer.
+	 * \param length Buffer length.
+	 * \return Returns CRC7 checksum.
+	 */
 	static uint8_t GetCrc7(uint8_t* buffer, uint8_t length);
-private:
-	static uint8_t crcTable[256];
+
+#ifdef _M_IX86
+	static uint8_t GetCrc7Table(uint8_t* buffer, uint8_t length);
+	static uint8_t GetCrc7Nibble(uint8_t* buffer, uint8_t length);
+	static uint8_t GetCrc7Bitwise(uint8_t* buffer, uint8_t length);
+#endif
 };
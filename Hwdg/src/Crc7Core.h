@@ -0,0 +1,140 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * \brief CRC7 engines shared by Hwdg and HwdgTiny, header must stay valid C.
+ */
+
+// 256-byte lookup table in flash, one lookup per byte
+#define CRC_ENGINE_TABLE      1
+// 16-entry lookup table in flash, two lookups per byte
+#define CRC_ENGINE_NIBBLE     2
+// No table, eight shifts per byte
+#define CRC_ENGINE_BITWISE    3
+
+#ifndef CRC_ENGINE
+// CRC7 implementation firmware is built with
+#define CRC_ENGINE CRC_ENGINE_TABLE
+#endif
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+// Tables stay in flash, AVR reads them with LPM
+#define CRC_FLASH PROGMEM
+#define CRC_READ(address) pgm_read_byte(address)
+#else
+// Const data is placed in flash by IAR STM8
+#define CRC_FLASH
+#define CRC_READ(address) (*(address))
+#endif
+
+#if CRC_ENGINE == CRC_ENGINE_TABLE || defined(_M_IX86)
+static const uint8_t crcTable[256] CRC_FLASH = {
+	0x00, 0x09, 0x12, 0x1b, 0x24, 0x2d, 0x36, 0x3f,
+	0x48, 0x41, 0x5a, 0x53, 0x6c, 0x65, 0x7e, 0x77,
+	0x19, 0x10, 0x0b, 0x02, 0x3d, 0x34, 0x2f, 0x26,
+	0x51, 0x58, 0x43, 0x4a, 0x75, 0x7c, 0x67, 0x6e,
+	0x32, 0x3b, 0x20, 0x29, 0x16, 0x1f, 0x04, 0x0d,
+	0x7a, 0x73, 0x68, 0x61, 0x5e, 0x57, 0x4c, 0x45,
+	0x2b, 0x22, 0x39, 0x30, 0x0f, 0x06, 0x1d, 0x14,
+	0x63, 0x6a, 0x71, 0x78, 0x47, 0x4e, 0x55, 0x5c,
+	0x64, 0x6d, 0x76, 0x7f, 0x40, 0x49, 0x52, 0x5b,
+	0x2c, 0x25, 0x3e, 0x37, 0x08, 0x01, 0x1a, 0x13,
+	0x7d, 0x74, 0x6f, 0x66, 0x59, 0x50, 0x4b, 0x42,
+	0x35, 0x3c, 0x27, 0x2e, 0x11, 0x18, 0x03, 0x0a,
+	0x56, 0x5f, 0x44, 0x4d, 0x72, 0x7b, 0x60, 0x69,
+	0x1e, 0x17, 0x0c, 0x05, 0x3a, 0x33, 0x28, 0x21,
+	0x4f, 0x46, 0x5d, 0x54, 0x6b, 0x62, 0x79, 0x70,
+	0x07, 0x0e, 0x15, 0x1c, 0x23, 0x2a, 0x31, 0x38,
+	0x41, 0x48, 0x53, 0x5a, 0x65, 0x6c, 0x77, 0x7e,
+	0x09, 0x00, 0x1b, 0x12, 0x2d, 0x24, 0x3f, 0x36,
+	0x58, 0x51, 0x4a, 0x43, 0x7c, 0x75, 0x6e, 0x67,
+	0x10, 0x19, 0x02, 0x0b, 0x34, 0x3d, 0x26, 0x2f,
+	0x73, 0x7a, 0x61, 0x68, 0x57, 0x5e, 0x45, 0x4c,
+	0x3b, 0x32, 0x29, 0x20, 0x1f, 0x16, 0x0d, 0x04,
+	0x6a, 0x63, 0x78, 0x71, 0x4e, 0x47, 0x5c, 0x55,
+	0x22, 0x2b, 0x30, 0x39, 0x06, 0x0f, 0x14, 0x1d,
+	0x25, 0x2c, 0x37, 0x3e, 0x01, 0x08, 0x13, 0x1a,
+	0x6d, 0x64, 0x7f, 0x76, 0x49, 0x40, 0x5b, 0x52,
+	0x3c, 0x35, 0x2e, 0x27, 0x18, 0x11, 0x0a, 0x03,
+	0x74, 0x7d, 0x66, 0x6f, 0x50, 0x59, 0x42, 0x4b,
+	0x17, 0x1e, 0x05, 0x0c, 0x33, 0x3a, 0x21, 0x28,
+	0x5f, 0x56, 0x4d, 0x44, 0x7b, 0x72, 0x69, 0x60,
+	0x0e, 0x07, 0x1c, 0x15, 0x2a, 0x23, 0x38, 0x31,
+	0x46, 0x4f, 0x54, 0x5d, 0x62, 0x6b, 0x70, 0x79
+};
+
+static inline uint8_t Crc7Table(const uint8_t* buffer, uint8_t length)
+{
+	uint8_t crc = 0;
+	while (length--)
+		crc = CRC_READ(&crcTable[crc << 1 ^ *buffer++]);
+	return crc;
+}
+#endif
+
+#if CRC_ENGINE == CRC_ENGINE_NIBBLE || defined(_M_IX86)
+// Left aligned CRC of the high nibble shifted through the register
+static const uint8_t crcNibbleTable[16] CRC_FLASH = {
+	0x00, 0x12, 0x24, 0x36, 0x48, 0x5a, 0x6c, 0x7e,
+	0x90, 0x82, 0xb4, 0xa6, 0xd8, 0xca, 0xfc, 0xee
+};
+
+static inline uint8_t Crc7Nibble(const uint8_t* buffer, uint8_t length)
+{
+	// CRC is kept left aligned, so the data byte is added as is.
+	uint8_t crc = 0;
+	while (length--)
+	{
+		crc ^= *buffer++;
+		crc = (uint8_t)(crc << 4) ^ CRC_READ(&crcNibbleTable[crc >> 4]);
+		crc = (uint8_t)(crc << 4) ^ CRC_READ(&crcNibbleTable[crc >> 4]);
+	}
+	return crc >> 1;
+}
+#endif
+
+#if CRC_ENGINE == CRC_ENGINE_BITWISE || defined(_M_IX86)
+static inline uint8_t Crc7Bitwise(const uint8_t* buffer, uint8_t length)
+{
+	// Polynomial x^7 + x^3 + 1 left aligned.
+	uint8_t crc = 0;
+	while (length--)
+	{
+		crc ^= *buffer++;
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = crc & 0x80 ? (uint8_t)(crc << 1) ^ 0x12 : (uint8_t)(crc << 1);
+	}
+	return crc >> 1;
+}
+#endif
+
+/**
+ * \brief Calculate CRC7 checksum with the engine selected by CRC_ENGINE.
+ */
+static inline uint8_t Crc7(const uint8_t* buffer, uint8_t length)
+{
+#if CRC_ENGINE == CRC_ENGINE_TABLE
+	return Crc7Table(buffer, length);
+#elif CRC_ENGINE == CRC_ENGINE_NIBBLE
+	return Crc7Nibble(buffer, length);
+#elif CRC_ENGINE == CRC_ENGINE_BITWISE
+	return Crc7Bitwise(buffer, length);
+#else
+#error Unknown CRC engine selected!
+#endif
+}
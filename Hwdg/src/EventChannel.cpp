@@ -0,0 +1,134 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "EventChannel.h"
+#include "Crc.h"
+
+// Events disabled
+#define MODE_OFF               ((uint8_t)0x00U)
+// Single byte events with fixed heartbeat
+#define MODE_LEGACY            ((uint8_t)0x01U)
+// Framed events with configurable heartbeat
+#define MODE_STREAM            ((uint8_t)0x02U)
+// hwdg event WatchdogOk elapse timeout, ms
+#define EVENT_HWDGOK_TIMEOUT   ((uint16_t)1000U)
+// Reset value
+#define INITIAL                ((uint8_t)0x00U)
+
+EventChannel::EventChannel(Uart& uart) :
+	uart(uart),
+	mode(MODE_OFF),
+	period(INITIAL),
+	seconds(INITIAL),
+	counterms(INITIAL),
+	sequence(INITIAL),
+	pending(INITIAL)
+{
+}
+
+Response EventChannel::Enable()
+{
+	mode = MODE_LEGACY;
+	return EnableEventsOk;
+}
+
+Response EventChannel::EnableStream(uint8_t period)
+{
+	mode = MODE_STREAM;
+	EventChannel::period = period;
+	seconds = INITIAL;
+	return SetEventStreamOk;
+}
+
+Response EventChannel::Disable()
+{
+	mode = MODE_OFF;
+	pending = INITIAL;
+	return DisableEventsOk;
+}
+
+bool EventChannel::IsEnabled()
+{
+	return mode != MODE_OFF;
+}
+
+bool EventChannel::IsStream(uint8_t& period)
+{
+	period = EventChannel::period;
+	return mode == MODE_STREAM;
+}
+
+void EventChannel::Post(Response event)
+{
+	// Unsolicited data would collide with responses of other boards on the
+	// bus. On AVR timer interrupt could also put it between response bytes.
+	if (Uart::IsBusMode()) return;
+	if (mode == MODE_LEGACY)
+	{
+		uart.SendByte(event);
+		return;
+	}
+	if (mode != MODE_STREAM) return;
+
+	// Every event takes its own sequence number even if coalesced
+	// with pending one, so the host sees how many it missed.
+	const uint8_t kind = event - FirstResetOccurred;
+	if (kind >= EVENT_KINDS) return;
+	sequences[kind] = ++sequence;
+	pending |= 1U << kind;
+}
+
+void EventChannel::Tick()
+{
+	if (mode == MODE_OFF || Uart::IsBusMode()) return;
+
+	if (++counterms >= EVENT_HWDGOK_TIMEOUT)
+	{
+		counterms = INITIAL;
+		if (mode == MODE_LEGACY)
+			uart.SendByte(WatchdogOk);
+		else if (period && ++seconds >= period)
+		{
+			seconds = INITIAL;
+			Post(WatchdogOk);
+		}
+	}
+
+	// Frame is sent whole only when transmitter is idle, so command
+	// responses never get in between frame bytes.
+	if (!pending || !uart.IsTxIdle()) return;
+
+	// Pending events go out in sequence order, so frames the host
+	// receives always have increasing sequence numbers.
+	uint8_t kind = INITIAL;
+	uint8_t age = INITIAL;
+	for (uint8_t i = 0; i < EVENT_KINDS; i++)
+	{
+		if (!(pending & 1U << i)) continue;
+		const uint8_t a = sequence - sequences[i];
+		if (a >= age)
+		{
+			age = a;
+			kind = i;
+		}
+	}
+	pending &= ~(1U << kind);
+
+	uint8_t frame[EVENT_FRAME_SIZE];
+	frame[0] = EVENT_MARKER;
+	frame[1] = sequences[kind];
+	frame[2] = FirstResetOccurred + kind;
+	frame[3] = CrcCalculator::GetCrc7(frame, EVENT_FRAME_SIZE - 1);
+	uart.SendData(frame, EVENT_FRAME_SIZE);
+}
@@ -0,0 +1,87 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "Response.h"
+#include "Uart.h"
+
+// Event stream frame marker, never used as single byte response
+#define EVENT_MARKER           ((uint8_t)0xA5U)
+// Event stream frame size: marker, sequence, event and CRC7, bytes
+#define EVENT_FRAME_SIZE       ((uint8_t)4U)
+// Event kinds count, events are numbered from FirstResetOccurred
+#define EVENT_KINDS            ((uint8_t)5U)
+
+/**
+ * \brief Delivers reset controller events to the host, assumes Tick() calls every 1 ms.
+ * \remarks Legacy mode sends every event as a single byte and WatchdogOk once per second.
+ * Stream mode sends events framed with sequence number and coalesces events of the same
+ * kind posted while the previous one still waits for UART.
+ */
+class EventChannel
+{
+public:
+	/**
+	 * \brief Create instance of event channel, events are disabled.
+	 * \param uart UART events are sent through.
+	 */
+	EventChannel(Uart& uart);
+
+	/**
+	 * \brief Enable legacy single byte events.
+	 */
+	Response Enable();
+
+	/**
+	 * \brief Enable framed event stream.
+	 * \param period WatchdogOk heartbeat period in seconds, 0 disables heartbeat.
+	 */
+	Response EnableStream(uint8_t period);
+
+	/**
+	 * \brief Disable events.
+	 */
+	Response Disable();
+
+	/**
+	 * \brief Determine if events enabled in any mode.
+	 */
+	bool IsEnabled();
+
+	/**
+	 * \brief Determine if framed event stream enabled.
+	 * \param period WatchdogOk heartbeat period in seconds of the stream.
+	 */
+	bool IsStream(uint8_t& period);
+
+	/**
+	 * \brief Post event, does nothing if events disabled.
+	 * \param event Event to be sent.
+	 */
+	void Post(Response event);
+
+	/**
+	 * \brief Run heartbeat and send pending frame if UART is idle.
+	 */
+	void Tick();
+private:
+	Uart& uart;
+	uint8_t mode;
+	uint8_t period;
+	uint8_t seconds;
+	uint16_t counterms;
+	uint8_t sequence;
+	uint8_t pending;
+	uint8_t sequences[EVENT_KINDS];
+};
@@ -0,0 +1,54 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "FrequencyScaler.h"
+
+#ifndef SCALER_HOLD_TIMEOUT
+// Time CPU stays at high frequency after the last boost, ms (1-255)
+#define SCALER_HOLD_TIMEOUT    ((uint8_t)100U)
+#endif
+#ifndef SCALER_LOW_FREQ
+// CPU frequency while idle
+#define SCALER_LOW_FREQ        Freq2Mhz
+#endif
+#ifndef SCALER_HIGH_FREQ
+// CPU frequency while boosted
+#define SCALER_HIGH_FREQ       Freq16Mhz
+#endif
+// Reset value
+#define INITIAL                ((uint8_t)0x00U)
+
+FrequencyScaler::FrequencyScaler(Timer& timer) :
+	timer(timer),
+	hold(SCALER_HOLD_TIMEOUT)
+{
+	timer.SubscribeOnElapse(*this);
+}
+
+FrequencyScaler::~FrequencyScaler()
+{
+	timer.UnsubscribeOnElapse(*this);
+}
+
+void FrequencyScaler::Boost()
+{
+	hold = SCALER_HOLD_TIMEOUT;
+	if (Clock::GetCpuFreq() != SCALER_HIGH_FREQ) Clock::SetCpuFreq(SCALER_HIGH_FREQ);
+}
+
+void FrequencyScaler::Callback(uint8_t data)
+{
+	if (hold == INITIAL || --hold != INITIAL) return;
+	Clock::SetCpuFreq(SCALER_LOW_FREQ);
+}
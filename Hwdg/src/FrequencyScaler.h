@@ -0,0 +1,47 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "Clock.h"
+#include "Timer.h"
+
+/**
+ * \brief Runs CPU at low frequency while idle and boosts it on demand.
+ * \remarks Only CPU clock is scaled, master clock of Timer and UART stays
+ * the same, so switch is safe in the middle of a byte being transferred.
+ */
+class FrequencyScaler : ISubscriber
+{
+public:
+	/**
+	 * \brief Create instance of frequency scaler.
+	 * \param timer Timer to get 1 ms timebase from.
+	 */
+	FrequencyScaler(Timer& timer);
+
+	/**
+	 * \brief Dispose frequency scaler.
+	 */
+	~FrequencyScaler();
+
+	/**
+	 * \brief Switch to high frequency and stay there until boost hold timeout elapses.
+	 * \remarks Safe to call from both interrupt and main loop contexts.
+	 */
+	_virtual void Boost();
+private:
+	void Callback(uint8_t data) _override;
+	Timer& timer;
+	volatile uint8_t hold;
+};
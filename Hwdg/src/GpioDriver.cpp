@@ -19,6 +19,7 @@
 #define PWR_PIN (1 << 2)
 #define RST_PIN (1 << 3)
 #define LED_PIN (1 << 6)
+#define ACT_PIN (1 << 4)
 #endif
 
 #ifdef __AVR__
@@ -32,6 +33,16 @@
 #ifndef LED_PIN
 #define LED_PIN LED_BUILTIN
 #endif
+#ifndef ACT_PIN
+// Activity input must be external interrupt capable pin
+#define ACT_PIN 2
+#endif
+#endif
+
+volatile uint16_t GpioDriver::activityEdges = 0;
+#ifdef _M_IX86
+bool GpioDriver::resetLow = false;
+bool GpioDriver::powerLow = false;
 #endif
 
 GpioDriver::GpioDriver()
@@ -41,11 +52,19 @@ GpioDriver::GpioDriver()
 	GPIOD->DDR |= PWR_PIN | RST_PIN;
 	GPIOC->DDR |= LED_PIN;
 	GPIOC->CR1 |= LED_PIN;
+
+	// Activity input is pulled up and counts falling edges in EXTI
+	// interrupt, sensitivity can only be changed while interrupts disabled.
+	GPIOD->CR1 |= ACT_PIN;
+	GPIOD->CR2 |= ACT_PIN;
+	EXTI->CR1 = (EXTI->CR1 & ~EXTI_CR1_PDIS) | EXTI_CR1_PDIS_1;
 #endif
 #ifdef __AVR__
 	pinMode(PWR_PIN, INPUT);
 	pinMode(RST_PIN, INPUT);
 	pinMode(LED_PIN, OUTPUT);
+	pinMode(ACT_PIN, INPUT_PULLUP);
+	attachInterrupt(digitalPinToInterrupt(ACT_PIN), OnActivityEdge, FALLING);
 #endif
 }
 
@@ -56,11 +75,15 @@ GpioDriver::~GpioDriver()
 	GPIOD->DDR &= ~(PWR_PIN | RST_PIN);
 	GPIOC->DDR &= ~LED_PIN;
 	GPIOC->CR1 &= ~LED_PIN;
+	GPIOD->CR2 &= ~ACT_PIN;
+	GPIOD->CR1 &= ~ACT_PIN;
 #endif
 #ifdef __AVR__
+	detachInterrupt(digitalPinToInterrupt(ACT_PIN));
 	pinMode(PWR_PIN, INPUT);
 	pinMode(RST_PIN, INPUT);
 	pinMode(LED_PIN, INPUT);
+	pinMode(ACT_PIN, INPUT);
 #endif
 }
 
@@ -69,6 +92,9 @@ void GpioDriver::DriveResetLow()
 #ifdef __ICCSTM8__
 	GPIOD->ODR &= ~RST_PIN;
 #endif
+#ifdef _M_IX86
+	resetLow = true;
+#endif
 #ifdef __AVR__
 	pinMode(RST_PIN, OUTPUT);
 #endif
@@ -79,6 +105,9 @@ void GpioDriver::ReleaseReset()
 #ifdef __ICCSTM8__
 	GPIOD->ODR |= RST_PIN;
 #endif
+#ifdef _M_IX86
+	resetLow = false;
+#endif
 #ifdef __AVR__
 	pinMode(RST_PIN, INPUT);
 #endif
@@ -89,6 +118,9 @@ void GpioDriver::DrivePowerLow()
 #ifdef __ICCSTM8__
 	GPIOD->ODR &= ~PWR_PIN;
 #endif
+#ifdef _M_IX86
+	powerLow = true;
+#endif
 #ifdef __AVR__
 	pinMode(PWR_PIN, OUTPUT);
 #endif
@@ -99,6 +131,9 @@ void GpioDriver::ReleasePower()
 #ifdef __ICCSTM8__
 	GPIOD->ODR |= PWR_PIN;
 #endif
+#ifdef _M_IX86
+	powerLow = false;
+#endif
 #ifdef __AVR__
 	pinMode(PWR_PIN, INPUT);
 #endif
@@ -123,3 +158,66 @@ void GpioDriver::DriveLedHigh()
 	digitalWrite(LED_PIN, HIGH);
 #endif
 }
+
+uint16_t GpioDriver::GetActivityEdges()
+{
+#ifdef __AVR__
+	// 16-bit read takes two instructions on AVR, keep edge ISR out of it.
+	const uint8_t sreg = SREG;
+	cli();
+	const uint16_t edges = activityEdges;
+	SREG = sreg;
+	return edges;
+#else
+	return activityEdges;
+#endif
+}
+
+bool GpioDriver::IsResetLineLow()
+{
+#ifdef __ICCSTM8__
+	return !(GPIOD->IDR & RST_PIN);
+#endif
+#ifdef _M_IX86
+	return resetLow;
+#endif
+#ifdef __AVR__
+	return digitalRead(RST_PIN) == LOW;
+#endif
+}
+
+bool GpioDriver::IsPowerLineLow()
+{
+#ifdef __ICCSTM8__
+	return !(GPIOD->IDR & PWR_PIN);
+#endif
+#ifdef _M_IX86
+	return powerLow;
+#endif
+#ifdef __AVR__
+	return digitalRead(PWR_PIN) == LOW;
+#endif
+}
+
+#ifdef _M_IX86
+void GpioDriver::SimulateLineLevels(bool resetLow, bool powerLow)
+{
+	GpioDriver::resetLow = resetLow;
+	GpioDriver::powerLow = powerLow;
+}
+
+void GpioDriver::SimulateActivityLevel(bool level)
+{
+	// Mirror hardware: pulled up input counts falling edges only.
+	if (activityLevel && !level) OnActivityEdge();
+	activityLevel = level;
+}
+#endif
+
+#ifdef __ICCSTM8__
+#pragma vector=EXTI3_ISR
+#endif
+__interrupt void GpioDriver::OnActivityEdge()
+{
+	activityEdges++;
+}
@@ -14,6 +14,7 @@
 
 #pragma once
 #include "PlatformDefinitions.h"
+#include <stdint.h>
 
 /**
  * \brief Represents Low level GPIO driver.
@@ -53,4 +54,48 @@ public:
 	 * \brief Drive LED pin high.
 	 */
 	_virtual void DriveLedHigh();
+	/**
+	 * \brief Get free running activity input edges counter.
+	 * \remarks Counter wraps around, consumer takes difference between two reads
+	 * so that ISR and consumer never have to reset it concurrently. It is 16 bits
+	 * wide, so that a busy window never wraps it all the way back to no activity.
+	 */
+	_virtual uint16_t GetActivityEdges();
+	/**
+	 * \brief Sense reset line level.
+	 * \return Returns true if reset line is actually low.
+	 * \remarks Meaningful only while the line is released, so that motherboard pull-up
+	 * is seen. Driven line always reads low.
+	 */
+	static bool IsResetLineLow();
+	/**
+	 * \brief Sense power line level.
+	 * \return Returns true if power line is actually low.
+	 * \remarks Meaningful only while the line is released, so that motherboard pull-up
+	 * is seen. Driven line always reads low.
+	 */
+	static bool IsPowerLineLow();
+#ifdef _M_IX86
+	/**
+	 * \brief Simulate reset and power line levels (host builds only).
+	 * \remarks Lines follow the driver unless overridden.
+	 */
+	static void SimulateLineLevels(bool resetLow, bool powerLow);
+	/**
+	 * \brief Simulate activity input level (host builds only).
+	 * \param level Input level, every level change counts as an edge.
+	 */
+	void SimulateActivityLevel(bool level);
+#endif
+	/**
+	 * \brief Occures on activity input edge.
+	 */
+	__interrupt static void OnActivityEdge();
+private:
+	static volatile uint16_t activityEdges;
+#ifdef _M_IX86
+	static bool resetLow;
+	static bool powerLow;
+	bool activityLevel = true;
+#endif
 };
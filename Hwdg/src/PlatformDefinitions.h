@@ -18,6 +18,8 @@
 #define _virtual
 #define _override
 #define nullptr 0
+// IAR never moves memory accesses across inline assembler statement
+#define MEMORY_BARRIER() asm("")
 #endif
 
 #ifdef _M_IX86
@@ -27,10 +29,13 @@
 #define __eeprom
 #define __near
 #define _override override
+#include <atomic>
+#define MEMORY_BARRIER() std::atomic_thread_fence(std::memory_order_seq_cst)
 #endif
 
 #ifdef __AVR__
 #define _virtual
 #define _override
 #define __interrupt
+#define MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
 #endif
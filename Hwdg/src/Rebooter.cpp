@@ -13,20 +13,29 @@
 // limitations under the License.
 
 #include "Rebooter.h"
+#include "WatchdogCore.h"
+
+#ifdef __ICCSTM8__
+#include <intrinsics.h>
+#endif
+
+#ifdef __AVR__
+#include "Arduino.h"
+#endif
 
 #ifndef RST_TIM
 // Soft reset pin low level duration
-#define RST_TIM             ((uint_fast16_t)200U)
+#define RST_TIM             ((uint_fast16_t)RST_PULSE)
 #endif
 
 #ifndef HR_LO_TIM
 // Hard reset pin low level duration
-#define HR_LO_TIM           ((uint_fast16_t)6000U)
+#define HR_LO_TIM           ((uint_fast16_t)HR_OFF_PULSE)
 #endif
 
 #ifndef HR_HI_TIM
 // Hard reset pin high level duration
-#define HR_HI_TIM           ((uint_fast16_t)2000U)
+#define HR_HI_TIM           ((uint_fast16_t)HR_ON_DELAY)
 #endif
 // Reboot is in proccess
 #define IN_PROCESS          ((uint_least8_t)0x10U)
@@ -40,10 +49,33 @@
 #define HR_HI_ELAPSED       ((uint_least8_t)0x08U)
 // Power pulse token
 #define POWER_PULSE         ((uint_least8_t)0x20U)
+#ifndef RISE_TIMEOUT
+// Time released line is given to get pulled up by motherboard, ms
+#define RISE_TIMEOUT        ((uint_fast16_t)10U)
+#endif
+// Reset line token
+#define RST_LINE            ((uint_least8_t)0x01U)
+// Power line token
+#define PWR_LINE            ((uint_least8_t)0x02U)
+// Pending actions queue index mask
+#define QUEUE_MASK          ((uint_least8_t)(REBOOTER_QUEUE_SIZE - 1))
 // Reset value
 #define INITIAL             ((uint_least8_t)0x00U)
 
-Rebooter::Rebooter(Timer& tmr, GpioDriver& driver) : timer(tmr), driver(driver), state(INITIAL), counter(INITIAL)
+Rebooter::Rebooter(Timer& tmr, GpioDriver& driver) :
+	timer(tmr),
+	driver(driver),
+	state(INITIAL),
+	counter(INITIAL),
+	current(INITIAL),
+	listener(nullptr),
+	queueHead(INITIAL),
+	queueCount(INITIAL),
+	driveTime(INITIAL),
+	riseTime(INITIAL),
+	released(INITIAL),
+	pulledUp(false),
+	stats()
 {
 	timer.SubscribeOnElapse(*this);
 }
@@ -53,31 +85,19 @@ Rebooter::~Rebooter()
 	timer.UnsubscribeOnElapse(*this);
 }
 
-Response Rebooter::HardReset()
+Response Rebooter::HardReset(uint_fast16_t delay, ISubscriber* listener)
 {
-	if (state & IN_PROCESS) return Busy;
-	state = IN_PROCESS | HARD_RESET;
-	driver.DrivePowerLow();
-	counter = INITIAL;
-	return TestHardResetOk;
+	return Schedule(HARD_RESET, delay, listener);
 }
 
-Response Rebooter::PwrPulse()
+Response Rebooter::PwrPulse(uint_fast16_t delay, ISubscriber* listener)
 {
-	if (state & IN_PROCESS) return Busy;
-	state = IN_PROCESS | SOFT_RESET | POWER_PULSE;
-	driver.DrivePowerLow();
-	counter = INITIAL;
-	return PowerPulseOk;
+	return Schedule(POWER_PULSE, delay, listener);
 }
 
-Response Rebooter::SoftReset()
+Response Rebooter::SoftReset(uint_fast16_t delay, ISubscriber* listener)
 {
-	if (state & IN_PROCESS) return Busy;
-	state = IN_PROCESS | SOFT_RESET;
-	driver.DriveResetLow();
-	counter = INITIAL;
-	return TestSoftResetOk;
+	return Schedule(SOFT_RESET, delay, listener);
 }
 
 Timer& Rebooter::GetTimer()
@@ -85,8 +105,201 @@ Timer& Rebooter::GetTimer()
 	return timer;
 }
 
+GpioDriver& Rebooter::GetDriver()
+{
+	return driver;
+}
+
+Response Rebooter::Schedule(uint_least8_t token, uint_fast16_t delay, ISubscriber* listener)
+{
+	Response response = token == HARD_RESET
+		? TestHardResetOk
+		: token == POWER_PULSE
+		? PowerPulseOk
+		: TestSoftResetOk;
+
+	// Actions are requested both from interrupts and from main loop.
+#ifdef __ICCSTM8__
+	const __istate_t istate = __get_interrupt_state();
+	__disable_interrupt();
+#endif
+#ifdef __AVR__
+	const uint8_t sreg = SREG;
+	cli();
+#endif
+
+	// Repeated request of the action that is not started or completed yet
+	// would only extend the outage, so merge it with the last one.
+	Action* action = queueCount
+		? &queue[(queueHead + queueCount - 1) & QUEUE_MASK]
+		: nullptr;
+	if (action != nullptr ? action->token == token : state & IN_PROCESS && current == token)
+	{
+		ISubscriber*& merged = action != nullptr ? action->listener : this->listener;
+		if (merged == nullptr) merged = listener;
+	}
+	else if (queueCount == REBOOTER_QUEUE_SIZE)
+	{
+		response = Busy;
+	}
+	else
+	{
+		action = &queue[(queueHead + queueCount++) & QUEUE_MASK];
+		action->token = token;
+		action->delay = delay;
+		action->listener = listener;
+
+		// Idle rebooter starts immediate action right away.
+		if (!(state & IN_PROCESS) && queueCount == 1 && !delay) Dequeue();
+	}
+
+#ifdef __ICCSTM8__
+	__set_interrupt_state(istate);
+#endif
+#ifdef __AVR__
+	SREG = sreg;
+#endif
+	return response;
+}
+
+void Rebooter::Dequeue()
+{
+	if (!queueCount) return;
+
+	// Delay counts from previous action completion.
+	Action& action = queue[queueHead];
+	if (action.delay)
+	{
+		action.delay--;
+		return;
+	}
+	queueHead = (queueHead + 1) & QUEUE_MASK;
+	queueCount--;
+	Begin(action);
+}
+
+void Rebooter::Begin(const Action& action)
+{
+	current = action.token;
+	listener = action.listener;
+	counter = INITIAL;
+	driveTime = INITIAL;
+
+	// Driven line always reads low, so motherboard pull-up is sensed while
+	// the line is still released. Line released on this very tick had no
+	// time to rise, its rise was to be checked after this pulse anyway.
+	const uint_least8_t line = current == SOFT_RESET ? RST_LINE : PWR_LINE;
+	pulledUp = released == line || !IsLineLow(line);
+	if (!pulledUp) stats.failures++;
+
+	if (current == HARD_RESET)
+	{
+		state = IN_PROCESS | HARD_RESET;
+		driver.DrivePowerLow();
+	}
+	else if (current == POWER_PULSE)
+	{
+		state = IN_PROCESS | SOFT_RESET | POWER_PULSE;
+		driver.DrivePowerLow();
+	}
+	else
+	{
+		state = IN_PROCESS | SOFT_RESET;
+		driver.DriveResetLow();
+	}
+}
+
+void Rebooter::Complete()
+{
+	state = INITIAL;
+
+	// Line that wasn't pulled up before the pulse is already counted as failed.
+	stats.pulses++;
+	stats.lastDriveTime = uint16_t(driveTime);
+	released = pulledUp ? current == SOFT_RESET ? RST_LINE : PWR_LINE : INITIAL;
+	riseTime = INITIAL;
+
+	// Listener is called from timer interrupt, it must return quickly.
+	if (listener != nullptr)
+		listener->Callback(current == HARD_RESET
+			? TestHardResetOk
+			: current == POWER_PULSE
+			? PowerPulseOk
+			: TestSoftResetOk);
+	listener = nullptr;
+
+	// Next action may follow without any gap.
+	Dequeue();
+}
+
+void Rebooter::GetPulseStats(PulseStats& stats)
+{
+#ifdef __ICCSTM8__
+	const __istate_t istate = __get_interrupt_state();
+	__disable_interrupt();
+#endif
+#ifdef __AVR__
+	const uint8_t sreg = SREG;
+	cli();
+#endif
+	stats = this->stats;
+#ifdef __ICCSTM8__
+	__set_interrupt_state(istate);
+#endif
+#ifdef __AVR__
+	SREG = sreg;
+#endif
+}
+
+uint_least8_t Rebooter::GetDrivenLine()
+{
+	if (!(state & IN_PROCESS) || state & HR_LO_ELAPSED) return INITIAL;
+	return state & (HARD_RESET | HR_HI_ELAPSED | POWER_PULSE)
+		? PWR_LINE
+		: RST_LINE;
+}
+
+bool Rebooter::IsLineLow(uint_least8_t line)
+{
+	return line == RST_LINE
+		? GpioDriver::IsResetLineLow()
+		: GpioDriver::IsPowerLineLow();
+}
+
 void Rebooter::Callback(uint8_t data)
 {
+	// Released line must get pulled up within RISE_TIMEOUT, otherwise it's
+	// stuck or held by something else. Once the next action drives the same
+	// line again its rise can't be seen any more.
+	const uint_least8_t line = GetDrivenLine();
+	if (released == line)
+	{
+		released = INITIAL;
+	}
+	else if (released)
+	{
+		riseTime++;
+		if (!IsLineLow(released))
+		{
+			stats.lastRiseTime = uint16_t(riseTime);
+			released = INITIAL;
+		}
+		else if (riseTime >= RISE_TIMEOUT)
+		{
+			stats.failures++;
+			stats.lastRiseTime = uint16_t(riseTime);
+			released = INITIAL;
+		}
+	}
+
+	if (line) driveTime++;
+
+	if (!(state & IN_PROCESS))
+	{
+		Dequeue();
+		return;
+	}
+
 	if (state & SOFT_RESET)
 	{
 		if (++counter >= RST_TIM)
@@ -94,7 +307,7 @@ void Rebooter::Callback(uint8_t data)
 			state & HR_HI_ELAPSED || state & POWER_PULSE
 				? driver.ReleasePower()
 				: driver.ReleaseReset();
-			state = INITIAL;
+			Complete();
 			return;
 		}
 	}
@@ -17,6 +17,22 @@
 #include "Response.h"
 #include "Timer.h"
 
+#ifndef REBOOTER_QUEUE_SIZE
+// Pending actions queue capacity, power of two
+#define REBOOTER_QUEUE_SIZE 4
+#endif
+
+/**
+ * \brief Reset and power line sense results.
+ */
+struct PulseStats
+{
+	uint16_t pulses;
+	uint16_t failures;
+	uint16_t lastRiseTime;
+	uint16_t lastDriveTime;
+};
+
 /**
  * \brief Implements reboot logic
  */
@@ -37,18 +53,30 @@ public:
 
 	/**
 	 * \brief Satrt hard reset sequence.
+	 * \param delay Time between previous action completion and the sequence start, ms.
+	 * \param listener Subscriber notified with TestHardResetOk once the sequence completes.
+	 * \return Returns Busy if the queue is full.
+	 * \remarks Request duplicating the last queued or running hard reset is merged with it.
 	 */
-	_virtual Response HardReset();
+	_virtual Response HardReset(uint_fast16_t delay = 0, ISubscriber* listener = nullptr);
 
 	/**
 	 * \brief Send pulse on power pin.
+	 * \param delay Time between previous action completion and the pulse start, ms.
+	 * \param listener Subscriber notified with PowerPulseOk once the pulse completes.
+	 * \return Returns Busy if the queue is full.
+	 * \remarks Request duplicating the last queued or running power pulse is merged with it.
 	 */
-	_virtual Response PwrPulse();
+	_virtual Response PwrPulse(uint_fast16_t delay = 0, ISubscriber* listener = nullptr);
 
 	/**
 	 * \brief Start soft reset sequence.
+	 * \param delay Time between previous action completion and the sequence start, ms.
+	 * \param listener Subscriber notified with TestSoftResetOk once the sequence completes.
+	 * \return Returns Busy if the queue is full.
+	 * \remarks Request duplicating the last queued or running soft reset is merged with it.
 	 */
-	_virtual Response SoftReset();
+	_virtual Response SoftReset(uint_fast16_t delay = 0, ISubscriber* listener = nullptr);
 
 	/**
 	 * \brief Get timer reference.
@@ -56,10 +84,46 @@ public:
 	 */
 	_virtual Timer& GetTimer();
 
+	/**
+	 * \brief Get GPIO driver reference.
+	 * \return Returns GPIO driver reference.
+	 */
+	_virtual GpioDriver& GetDriver();
+
+	/**
+	 * \brief Get line sense results.
+	 * \param stats Pulses completed, failed ones (line wasn't pulled up before the pulse or
+	 * didn't rise after release), time the last pulse line took to rise and its drive time, ms.
+	 */
+	_virtual void GetPulseStats(PulseStats& stats);
+
 private:
+	struct Action
+	{
+		uint_least8_t token;
+		uint_fast16_t delay;
+		ISubscriber* listener;
+	};
+
 	Timer& timer;
 	GpioDriver& driver;
 	uint_least8_t state;
 	uint_fast16_t counter;
+	uint_least8_t current;
+	ISubscriber* listener;
+	Action queue[REBOOTER_QUEUE_SIZE];
+	uint_least8_t queueHead;
+	uint_least8_t queueCount;
+	uint_fast16_t driveTime;
+	uint_fast16_t riseTime;
+	uint_least8_t released;
+	bool pulledUp;
+	PulseStats stats;
+	Response Schedule(uint_least8_t token, uint_fast16_t delay, ISubscriber* listener);
+	void Dequeue();
+	void Begin(const Action& action);
+	void Complete();
+	uint_least8_t GetDrivenLine();
+	static bool IsLineLow(uint_least8_t line);
 	void Callback(uint8_t data) _override;
 };
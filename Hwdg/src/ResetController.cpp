@@ -14,6 +14,15 @@
 
 #include "ResetController.h"
 #include "Timer.h"
+#include "WatchdogCore.h"
+
+#ifdef __ICCSTM8__
+#include <intrinsics.h>
+#endif
+
+#ifdef __AVR__
+#include "Arduino.h"
+#endif
 
 #ifndef RESPONSE_DEF_TIMEOUT
 // Default response timeout, ms
@@ -23,18 +32,15 @@
 // Default reboot timeout, ms
 #define REBOOT_DEF_TIMEOUT     ((uint32_t)150000UL)
 #endif
-#ifndef REBOOT_MIN_TIMEOUT
-// Least reboot timeout value, ms
-#define REBOOT_MIN_TIMEOUT     ((uint32_t)10000UL)
-#endif
 
-#ifndef SR_TIMEBASE
-// Soft reset time base, ms
-#define SR_TIMEBASE            ((uint32_t)5000UL)
+#ifndef REARM_MIN_TIMEOUT
+// Least time after reset a ping is accepted as host recovery, ms
+#define REARM_MIN_TIMEOUT      ((uint32_t)10000UL)
 #endif
-#ifndef HR_TIMEBASE
-// Hard reset time base, ms
-#define HR_TIMEBASE            ((uint32_t)5000UL)
+
+#ifndef ACTIVITY_WINDOW
+// Activity input edges counting window, ms
+#define ACTIVITY_WINDOW        ((uint16_t)1000U)
 #endif
 
 #ifndef SR_ATTEMPTS
@@ -52,39 +58,91 @@
 #define RESPONSE_ELAPSED       ((uint8_t)(1U << 1U))
 // Hard reset enabled
 #define HR_ENABLED             ((uint8_t)(1U << 2U))
-// Response timeout elapsed
+// Activity input monitoring enabled
 #define HDD_MONITOR            ((uint8_t)(1U << 3U))
 // Response timeout elapsed
 #define LED_STARDED            ((uint8_t)(1U << 4U))
+// Re-arm monitoring on the first ping after reset
+#define AUTO_REARM             ((uint8_t)(1U << 5U))
+// Boot duration after the last reset measured
+#define BOOT_MEASURED          ((uint8_t)(1U << 6U))
+
 
+// Mask applied to extract adaptive reboot deviation factor
+#define FACTOR_MASK            ((uint8_t)0x0FU)
+// Boot statistics NVRAM resolution, ms
+#define BOOT_STAT_RESOLUTION   ((uint32_t)100U)
+// Shift applied to extract escalation stage action
+#define ACTION_SHIFT           ((uint8_t)6U)
+// Mask applied to extract escalation stage repeat count
+#define REPEAT_MASK            ((uint8_t)0x3FU)
+#ifdef _M_IX86
+// Point reader may be preempted at by simulated timer interrupt
+#define PREEMPTION_POINT()     if (preemption) preemption()
+void (*ResetController::preemption)() = nullptr;
+#else
+#define PREEMPTION_POINT()
+#endif
+
+// Command context changes FSM data with timer interrupt masked,
+// odd version tells readers the data is being updated meanwhile
+#if defined(__ICCSTM8__)
+#define BEGIN_UPDATE()         const __istate_t istate = __get_interrupt_state(); \
+                               __disable_interrupt(); version++; MEMORY_BARRIER()
+#define END_UPDATE()           MEMORY_BARRIER(); version++; __set_interrupt_state(istate)
+#elif defined(__AVR__)
+#define BEGIN_UPDATE()         const uint8_t sreg = SREG; cli(); version++; MEMORY_BARRIER()
+#define END_UPDATE()           MEMORY_BARRIER(); version++; SREG = sreg
+#else
+#define BEGIN_UPDATE()         version++; MEMORY_BARRIER()
+#define END_UPDATE()           MEMORY_BARRIER(); version++
+#endif
 
-// Mask applied to extract attempts value
-#define ATTEMPTS_MASK          ((uint8_t)0x07U)
-// Mask applied to extract reboot timeout value
-#define REBOOT_MASK            ((uint8_t)0x7FU)
-// Mask applied to extract response timeout value
-#define RESPONSE_MASK          ((uint8_t)0x3FU)
 // Reset value
 #define INITIAL                ((uint8_t)0x00U)
-// hwdg event WatchdogOk elapse timeout
-#define EVENT_HWDGOK_TIMEOUT   ((uint16_t)1000)
+// Time value that means the event never happened or is not scheduled
+#define NEVER                  ((uint32_t)0xFFFFFFFFUL)
 
 
 ResetController::ResetController(Uart& uart, Rebooter& rb, LedController& ledController) :
-	eventsEnabled(false),
-	uart(uart),
+	events(uart),
 	rebooter(rb),
 	ledController(ledController),
 	counter(INITIAL),
-	counterms(INITIAL),
 	state(INITIAL),
 	responseTimeout(RESPONSE_DEF_TIMEOUT),
 	rebootTimeout(REBOOT_DEF_TIMEOUT),
 	sAttempt(SR_ATTEMPTS),
 	hAttempt(HR_ATTEMPTS),
 	sAttemptCurr(SR_ATTEMPTS),
-	hAttemptCurr(HR_ATTEMPTS)
+	hAttemptCurr(HR_ATTEMPTS),
+	stage(INITIAL),
+	stageRepeat(INITIAL),
+	stageTimeout(REBOOT_DEF_TIMEOUT),
+	bootDuration(INITIAL),
+	bootMean(INITIAL),
+	bootDeviation(INITIAL),
+	bootSamples(INITIAL),
+	adaptiveFactor(INITIAL),
+	adaptiveMin(INITIAL),
+	adaptiveMax(REBOOT_MASK),
+	activityTimeout(INITIAL),
+	activityIdle(INITIAL),
+	activityWindow(INITIAL),
+	activityLast(INITIAL),
+	activityEdges(INITIAL),
+	version(INITIAL),
+	pingRequest(INITIAL),
+	uptime(INITIAL),
+	lastPing(INITIAL),
+	pings(INITIAL),
+	softResets(INITIAL),
+	hardResets(INITIAL),
+	totalSoftResets(INITIAL),
+	totalHardResets(INITIAL)
 {
+	for (uint8_t i = 0; i < ESCALATION_SIZE; i++)
+		escalation[i] = INITIAL;
 	rebooter.GetTimer().SubscribeOnElapse(*this);
 }
 
@@ -97,77 +155,264 @@ uint32_t ResetController::GetStatus()
 {
 	uint32_t result = INITIAL;
 	uint8_t* rs = reinterpret_cast<uint8_t*>(&result);
-	rs[0] = (rebootTimeout - REBOOT_MIN_TIMEOUT) / HR_TIMEBASE;
-	rs[1] = (responseTimeout / SR_TIMEBASE - 1) << 2 | state & 0x03;
-	rs[2] = (sAttemptCurr - 1) << 5 | (hAttemptCurr - 1) << 2 | (state & 0x0C) >> 2;
+	// State byte is read once, so all the flags come from the same timer tick.
+	const uint8_t st = state;
+	rs[0] = WdgRebootTimeoutCode(rebootTimeout) | (st & AUTO_REARM) << 2;
+	rs[1] = WdgResponseTimeoutCode(responseTimeout) << 2 | (st & 0x03);
+	rs[2] = (sAttemptCurr - 1) << 5 | (hAttemptCurr - 1) << 2 | (st & 0x0C) >> 2;
 	return result;
 }
 
 Response ResetController::Start()
 {
-	if (state & ENABLED) return Busy;
-	counter = INITIAL;
-	state &= ~(ENABLED | RESPONSE_ELAPSED | LED_STARDED);
-	state |= ENABLED;
-	sAttempt = sAttemptCurr;
-	hAttempt = hAttemptCurr;
-	ledController.BlinkSlow();
-	return StartOk;
+	// Timer may stop the FSM on its own, so the check belongs to the update.
+	BEGIN_UPDATE();
+	const bool busy = state & ENABLED;
+	if (!busy)
+	{
+		counter = INITIAL;
+		sAttempt = sAttemptCurr;
+		hAttempt = hAttemptCurr;
+		stage = INITIAL;
+		stageRepeat = INITIAL;
+		ResetActivity();
+		state = (state & ~(RESPONSE_ELAPSED | LED_STARDED)) | ENABLED;
+		ledController.BlinkSlow();
+	}
+	END_UPDATE();
+	return busy ? Busy : StartOk;
 }
 
 Response ResetController::Stop()
 {
+	BEGIN_UPDATE();
 	ledController.Glow();
 	state &= ~(ENABLED | RESPONSE_ELAPSED | LED_STARDED);
+	END_UPDATE();
 	return StopOk;
 }
 
+bool ResetController::ChangeIdleState(uint8_t set, uint8_t clear)
+{
+	BEGIN_UPDATE();
+	const bool idle = !(state & ENABLED);
+	if (idle) state = (state & ~clear) | set;
+	END_UPDATE();
+	return idle;
+}
+
 Response ResetController::EnableHardReset()
 {
-	if (state & ENABLED) return Busy;
-	state |= HR_ENABLED;
-	return EnableHardResetOk;
+	return ChangeIdleState(HR_ENABLED, INITIAL) ? EnableHardResetOk : Busy;
 }
 
 Response ResetController::DisableHardReset()
 {
-	if (state & ENABLED) return Busy;
-	state &= ~HR_ENABLED;
-	return DisableHardResetOk;
+	return ChangeIdleState(INITIAL, HR_ENABLED) ? DisableHardResetOk : Busy;
+}
+
+Response ResetController::EnableAutoRearm()
+{
+	return ChangeIdleState(AUTO_REARM, INITIAL) ? EnableAutoRearmOk : Busy;
+}
+
+Response ResetController::DisableAutoRearm()
+{
+	return ChangeIdleState(INITIAL, AUTO_REARM) ? DisableAutoRearmOk : Busy;
+}
+
+uint32_t ResetController::GetLastBootDuration()
+{
+	return bootDuration;
 }
 
 Response ResetController::Ping()
 {
-	if (!(state & ENABLED) || state & RESPONSE_ELAPSED) return Busy;
-	counter = INITIAL;
+	ResetSnapshot snapshot;
+	GetSnapshot(snapshot);
+
+	// Counter, ping statistics and the rest of FSM data belong to timer
+	// interrupt, so ping is processed there on the next tick by the same rules.
+	pingRequest = ENABLED;
+	if (!(snapshot.state & ENABLED)) return Busy;
+	if (snapshot.state & RESPONSE_ELAPSED &&
+		(snapshot.counter < GetRearmTimeout(snapshot.deadline) || !(snapshot.state & AUTO_REARM)))
+		return Busy;
 	return PingOk;
 }
 
+void ResetController::GetSnapshot(ResetSnapshot& snapshot)
+{
+	// Version is wide enough not to wrap around while reader is preempted, torn
+	// version read on 8-bit core can't match the next read and just costs a retry.
+	uint16_t v;
+	do
+	{
+		v = version;
+		MEMORY_BARRIER();
+		snapshot.state = state;
+		PREEMPTION_POINT();
+		snapshot.counter = counter;
+		snapshot.deadline = snapshot.state & RESPONSE_ELAPSED ? stageTimeout : responseTimeout;
+		snapshot.bootDuration = bootDuration;
+		snapshot.bootSamples = bootSamples;
+		PREEMPTION_POINT();
+		snapshot.bootMean = bootMean;
+		snapshot.bootDeviation = bootDeviation;
+		snapshot.rebootTimeout = GetRebootTimeout();
+		snapshot.activityEdges = activityEdges;
+		snapshot.uptime = uptime;
+		snapshot.sincePing = pings ? uptime - lastPing : NEVER;
+		snapshot.pings = pings;
+		snapshot.untilAction = GetTimeUntilAction(snapshot);
+		snapshot.softResets = softResets;
+		snapshot.hardResets = hardResets;
+		snapshot.totalSoftResets = totalSoftResets;
+		snapshot.totalHardResets = totalHardResets;
+		MEMORY_BARRIER();
+	}
+	// Odd version means snapshot was taken while timer was updating
+	// data, changed version means timer ran during the snapshot.
+	while (v & 1 || v != version);
+}
+
+Response ResetController::SetActivityTimeout(uint8_t timeout)
+{
+	const uint32_t value = (timeout & RESPONSE_MASK) * SR_TIMEBASE;
+	BEGIN_UPDATE();
+	const bool busy = state & ENABLED;
+	if (!busy)
+	{
+		activityTimeout = value;
+		state = value ? state | HDD_MONITOR : state & ~HDD_MONITOR;
+	}
+	END_UPDATE();
+	return busy ? Busy : SetActivityTimeoutOk;
+}
+
+uint8_t ResetController::GetActivityEdges()
+{
+	return activityEdges;
+}
+
+Response ResetController::SetAdaptiveReboot(uint8_t factor, uint8_t min, uint8_t max)
+{
+	if (state & ENABLED) return Busy;
+	adaptiveFactor = factor & FACTOR_MASK;
+	adaptiveMin = min & REBOOT_MASK;
+	adaptiveMax = max & REBOOT_MASK;
+	if (adaptiveMax < adaptiveMin) adaptiveMax = adaptiveMin;
+	return SetAdaptiveRebootOk;
+}
+
+void ResetController::ExportAdaptiveReboot(uint8_t* data)
+{
+	ResetSnapshot snapshot;
+	GetSnapshot(snapshot);
+	const uint16_t mean = snapshot.bootMean / BOOT_STAT_RESOLUTION;
+	const uint16_t deviation = snapshot.bootDeviation / BOOT_STAT_RESOLUTION;
+	data[0] = adaptiveFactor;
+	data[1] = adaptiveMin;
+	data[2] = adaptiveMax;
+	data[3] = mean >> 8;
+	data[4] = mean & 0xFF;
+	data[5] = deviation >> 8;
+	data[6] = deviation & 0xFF;
+}
+
+void ResetController::ImportAdaptiveReboot(const uint8_t* data)
+{
+	if (SetAdaptiveReboot(data[0], data[1], data[2]) == Busy) return;
+	bootMean = (uint32_t)((uint16_t)data[3] << 8 | data[4]) * BOOT_STAT_RESOLUTION;
+	bootDeviation = (uint32_t)((uint16_t)data[5] << 8 | data[6]) * BOOT_STAT_RESOLUTION;
+	bootSamples = bootMean ? 1 : INITIAL;
+}
+
+uint32_t ResetController::GetRebootTimeout()
+{
+	if (!adaptiveFactor || !bootSamples) return rebootTimeout;
+
+	const uint32_t min = WdgRebootTimeout(adaptiveMin);
+	const uint32_t max = WdgRebootTimeout(adaptiveMax);
+	const uint32_t timeout = bootMean + adaptiveFactor * bootDeviation;
+	return timeout < min ? min : timeout > max ? max : timeout;
+}
+
+void ResetController::ImportResetCounters(uint32_t soft, uint32_t hard)
+{
+	if (state & ENABLED) return;
+	totalSoftResets = soft;
+	totalHardResets = hard;
+}
+
+uint32_t ResetController::GetPings()
+{
+	ResetSnapshot snapshot;
+	GetSnapshot(snapshot);
+	return snapshot.pings;
+}
+
+uint32_t ResetController::GetTimeUntilAction(const ResetSnapshot& snapshot)
+{
+	if (!(snapshot.state & ENABLED)) return NEVER;
+	if (snapshot.counter >= snapshot.deadline) return INITIAL;
+	uint32_t result = snapshot.deadline - snapshot.counter;
+
+	// Activity loss may fire earlier than response timeout.
+	if (snapshot.state & HDD_MONITOR && !(snapshot.state & RESPONSE_ELAPSED))
+	{
+		const uint32_t idle = activityIdle + activityWindow;
+		if (idle >= activityTimeout) return INITIAL;
+		if (activityTimeout - idle < result) result = activityTimeout - idle;
+	}
+	return result;
+}
+
+uint32_t ResetController::GetBootMean()
+{
+	return bootMean;
+}
+
+uint32_t ResetController::GetBootDeviation()
+{
+	return bootDeviation;
+}
+
+uint8_t ResetController::GetBootSamples()
+{
+	return bootSamples;
+}
+
+uint8_t ResetController::GetAdaptiveFactor()
+{
+	return adaptiveFactor;
+}
+
 Response ResetController::SetResponseTimeout(uint8_t timeout)
 {
 	if (state & ENABLED) return Busy;
-	responseTimeout = ((timeout & RESPONSE_MASK) + 1) * SR_TIMEBASE;
+	responseTimeout = WdgResponseTimeout(timeout);
 	return SetResponseTimeoutOk;
 }
 
 Response ResetController::SetRebootTimeout(uint8_t timeout)
 {
 	if (state & ENABLED) return Busy;
-	rebootTimeout = REBOOT_MIN_TIMEOUT + (timeout & REBOOT_MASK) * HR_TIMEBASE;
+	rebootTimeout = WdgRebootTimeout(timeout);
 	return SetRebootTimeoutOk;
 }
 
 Response ResetController::SetSoftResetAttempts(uint8_t attempts)
 {
 	if (state & ENABLED) return Busy;
-	sAttemptCurr = (attempts & ATTEMPTS_MASK) + 1;
+	sAttemptCurr = WdgAttempts(attempts);
 	return SetSoftResetAttemptsOk;
 }
 
 Response ResetController::SetHardResetAttempts(uint8_t attempts)
 {
 	if (state & ENABLED) return Busy;
-	hAttemptCurr = (attempts & ATTEMPTS_MASK) + 1;
+	hAttemptCurr = WdgAttempts(attempts);
 	return SetHardResetAttemptsOk;
 }
 
@@ -185,19 +430,41 @@ Response ResetController::TestSoftReset()
 
 Response ResetController::EnableEvents()
 {
-	eventsEnabled = true;
-	return EnableEventsOk;
+	return events.Enable();
 }
 
 Response ResetController::DisableEvents()
 {
-	eventsEnabled = false;
-	return DisableEventsOk;
+	return events.Disable();
+}
+
+Response ResetController::SetEventStream(uint8_t period)
+{
+	return events.EnableStream(period);
 }
 
 bool ResetController::IsEventsEnabled()
 {
-	return eventsEnabled;
+	return events.IsEnabled();
+}
+
+bool ResetController::IsEventStream(uint8_t& period)
+{
+	return events.IsStream(period);
+}
+
+Response ResetController::SetEscalationStage(uint8_t index, uint8_t action, uint8_t duration)
+{
+	if (state & ENABLED) return Busy;
+	if (index >= ESCALATION_STAGES) return InvalidArgument;
+	escalation[index * 2] = action;
+	escalation[index * 2 + 1] = duration;
+	return SetEscalationStageOk;
+}
+
+const uint8_t* ResetController::GetEscalation()
+{
+	return escalation;
 }
 
 Rebooter& ResetController::GetRebooter()
@@ -212,40 +479,74 @@ LedController& ResetController::GetLedController()
 
 void ResetController::Callback(uint8_t data)
 {
-	// WatchdogOk event logic
-	if (eventsEnabled)
+	// WatchdogOk event and pending event frames logic
+	events.Tick();
+
+	// Odd version tells readers FSM data is being updated.
+	version++;
+	MEMORY_BARRIER();
+
+	// Pings are counted even when reset controller is stopped.
+	if (pingRequest)
 	{
-		if (++counterms >= EVENT_HWDGOK_TIMEOUT)
-		{
-			counterms = INITIAL;
-			uart.SendByte(WatchdogOk);
-		}
+		pingRequest = INITIAL;
+		lastPing = uptime;
+		pings++;
+		if (state & ENABLED) OnPing();
 	}
 
 	// Reset controller FSM logic
-	if (!(state & ENABLED)) return;
+	if (state & ENABLED) Run();
+	uptime++;
 
+	MEMORY_BARRIER();
+	version++;
+}
+
+void ResetController::Run()
+{
 	counter++;
 
-	if (!(state & RESPONSE_ELAPSED) && counter >= responseTimeout)
+	// Host that still pings but shows no activity is considered hung as well.
+	if (state & HDD_MONITOR && !(state & RESPONSE_ELAPSED))
+		SampleActivity();
+
+	if (!(state & RESPONSE_ELAPSED) &&
+		(counter >= responseTimeout || (state & HDD_MONITOR && activityIdle >= activityTimeout)))
 	{
 		counter = INITIAL;
-		sAttempt--;
-		rebooter.SoftReset();
 		ledController.BlinkMid();
+		state &= ~BOOT_MEASURED;
 		state |= RESPONSE_ELAPSED;
-		if (eventsEnabled)
-			uart.SendByte(FirstResetOccurred);
+		stageTimeout = GetRebootTimeout();
+
+		// User defined escalation program takes precedence over
+		// default soft reset/hard reset sequence.
+		if (escalation[0] | escalation[1])
+		{
+			stage = INITIAL;
+			stageRepeat = INITIAL;
+			Escalate(true);
+			return;
+		}
+
+		sAttempt--;
+		IssueSoftReset();
+		events.Post(FirstResetOccurred);
 	}
-	else if (state & RESPONSE_ELAPSED && counter >= rebootTimeout)
+	else if (state & RESPONSE_ELAPSED && counter >= stageTimeout)
 	{
 		counter = INITIAL;
-		if (sAttempt > 0)
+		state &= ~BOOT_MEASURED;
+		if (escalation[0] | escalation[1])
+		{
+			Escalate(false);
+		}
+		else if (sAttempt > 0)
 		{
 			sAttempt--;
-			rebooter.SoftReset();
-			if (eventsEnabled)
-				uart.SendByte(SoftResetOccurred);
+			IssueSoftReset();
+			events.Post(SoftResetOccurred);
 		}
 		else if (state & HR_ENABLED && hAttempt > 0)
 		{
@@ -255,16 +556,163 @@ void ResetController::Callback(uint8_t data)
 				state |= LED_STARDED;
 				ledController.BlinkFast();
 			}
-			rebooter.HardReset();
-			if (eventsEnabled)
-				uart.SendByte(HardResetOccurred);
+			IssueHardReset(false);
+			events.Post(HardResetOccurred);
 		}
 		else
 		{
-			ledController.Glow();
-			state &= ~(ENABLED | RESPONSE_ELAPSED | LED_STARDED);
-			if (eventsEnabled)
-				uart.SendByte(MovedToIdle);
+			MoveToIdle();
 		}
 	}
 }
+
+void ResetController::OnPing()
+{
+	if (state & RESPONSE_ELAPSED)
+	{
+		// Pings that come right after reset are most
+		// likely sent before host actually went down.
+		if (counter < GetRearmTimeout(stageTimeout)) return;
+
+		// The first ping after reset tells how long host takes to boot.
+		if (!(state & BOOT_MEASURED))
+		{
+			state |= BOOT_MEASURED;
+			bootDuration = counter;
+			LearnBootDuration(counter);
+		}
+
+		// Ping after reset proves host recovered, so we may start
+		// monitoring again without waiting for reboot timeout.
+		if (!(state & AUTO_REARM)) return;
+		state &= ~(RESPONSE_ELAPSED | LED_STARDED);
+		sAttempt = sAttemptCurr;
+		hAttempt = hAttemptCurr;
+		stage = INITIAL;
+		stageRepeat = INITIAL;
+		ResetActivity();
+		ledController.BlinkSlow();
+	}
+	counter = INITIAL;
+}
+
+uint32_t ResetController::GetRearmTimeout(uint32_t deadline)
+{
+	// Counter restarts on every escalation step, so steps shorter than
+	// REARM_MIN_TIMEOUT would never let the host re-arm. Half a step
+	// still filters out pings sent right before the reset.
+	return deadline / 2 < REARM_MIN_TIMEOUT ? deadline / 2 : REARM_MIN_TIMEOUT;
+}
+
+void ResetController::Escalate(bool first)
+{
+	// Program is over when we run out of stages or meet terminating one.
+	if (stage >= ESCALATION_STAGES || !(escalation[stage * 2] | escalation[stage * 2 + 1]))
+	{
+		MoveToIdle();
+		return;
+	}
+
+	const uint8_t action = escalation[stage * 2];
+	const uint8_t duration = escalation[stage * 2 + 1];
+	uint8_t event = INITIAL;
+
+	switch (action >> ACTION_SHIFT)
+	{
+	case ActionRstPulse:
+		IssueSoftReset();
+		event = SoftResetOccurred;
+		break;
+	case ActionPwrPulse:
+	case ActionPowerCycle:
+		if (!(state & LED_STARDED))
+		{
+			state |= LED_STARDED;
+			ledController.BlinkFast();
+		}
+		IssueHardReset(action >> ACTION_SHIFT == ActionPwrPulse);
+		event = HardResetOccurred;
+		break;
+	default:
+		break;
+	}
+
+	// The very first step reports response timeout elapsed whatever action it takes.
+	if (first) event = FirstResetOccurred;
+	if (event != INITIAL)
+		events.Post(static_cast<Response>(event));
+
+	stageTimeout = duration ? duration * HR_TIMEBASE : GetRebootTimeout();
+	if (++stageRepeat > (action & REPEAT_MASK))
+	{
+		stage++;
+		stageRepeat = INITIAL;
+	}
+}
+
+void ResetController::LearnBootDuration(uint32_t duration)
+{
+	// Moving average and mean deviation with 1/8 and 1/4 gains respectively,
+	// the same estimator TCP uses for retransmission timeout. Mean deviation
+	// approximates standard deviation without any multiplication.
+	if (!bootSamples)
+	{
+		bootMean = duration;
+		bootDeviation = duration / 2;
+	}
+	else
+	{
+		const uint32_t error = duration > bootMean ? duration - bootMean : bootMean - duration;
+		bootDeviation = bootDeviation - (bootDeviation >> 2) + (error >> 2);
+		bootMean = bootMean - (bootMean >> 3) + (duration >> 3);
+	}
+	if (bootSamples < 0xFF) bootSamples++;
+}
+
+void ResetController::IssueSoftReset()
+{
+	rebooter.SoftReset();
+	softResets++;
+	totalSoftResets++;
+}
+
+void ResetController::IssueHardReset(bool pulse)
+{
+	pulse
+		? rebooter.PwrPulse()
+		: rebooter.HardReset();
+	hardResets++;
+	totalHardResets++;
+}
+
+void ResetController::ResetActivity()
+{
+	activityIdle = INITIAL;
+	activityWindow = INITIAL;
+	activityEdges = INITIAL;
+	if (state & HDD_MONITOR)
+		activityLast = rebooter.GetDriver().GetActivityEdges();
+}
+
+void ResetController::SampleActivity()
+{
+	if (++activityWindow < ACTIVITY_WINDOW) return;
+	activityWindow = INITIAL;
+
+	// Edges counter is free running, so the difference is edges
+	// count during the window even if counter wrapped around.
+	const uint16_t edges = rebooter.GetDriver().GetActivityEdges();
+	const uint16_t count = edges - activityLast;
+	activityEdges = count < 0xFF ? (uint8_t)count : 0xFF;
+	activityLast = edges;
+	activityEdges
+		? activityIdle = INITIAL
+		: activityIdle += ACTIVITY_WINDOW;
+}
+
+void ResetController::MoveToIdle()
+{
+	ledController.Glow();
+	state &= ~(ENABLED | RESPONSE_ELAPSED | LED_STARDED);
+	events.Post(MovedToIdle);
+}
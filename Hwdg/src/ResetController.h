@@ -13,12 +13,63 @@
 // limitations under the License.
 
 #pragma once
+#include "EventChannel.h"
 #include "LedController.h"
 #include "Rebooter.h"
 #include "Uart.h"
 
+// Adaptive reboot settings size (factor, bounds and learned statistics), bytes
+#define ADAPTIVE_REBOOT_SIZE   ((uint8_t)7U)
+
+#ifndef ESCALATION_STAGES
+// Escalation program capacity, stages
+#define ESCALATION_STAGES      ((uint8_t)4U)
+#endif
+// Escalation program size, bytes (two bytes per stage)
+#define ESCALATION_SIZE        ((uint8_t)(ESCALATION_STAGES * 2U))
+
+/**
+ * \brief Escalation stage action.
+ */
+enum EscalationAction
+{
+	ActionWait = 0x00,
+	ActionRstPulse = 0x01,
+	ActionPwrPulse = 0x02,
+	ActionPowerCycle = 0x03
+};
+
+/**
+ * \brief Reset controller data copy consistent with respect to timer interrupt.
+ */
+struct ResetSnapshot
+{
+	uint32_t counter;
+	uint32_t deadline;
+	uint32_t bootDuration;
+	uint32_t bootMean;
+	uint32_t bootDeviation;
+	uint32_t rebootTimeout;
+	uint32_t uptime;
+	uint32_t sincePing;
+	uint32_t pings;
+	uint32_t untilAction;
+	uint32_t totalSoftResets;
+	uint32_t totalHardResets;
+	uint16_t softResets;
+	uint16_t hardResets;
+	uint8_t state;
+	uint8_t bootSamples;
+	uint8_t activityEdges;
+};
+
 /**
  * \brief Reset controller assumes Callback() calls every 1 ms.
+ * \remarks FSM data is written by timer interrupt. Command context changes FSM state
+ * with timer interrupt masked and bumps the version as the timer does, pings are handed
+ * over to the next tick. Settings timer reads only while FSM runs are written by command
+ * context while it is stopped. Other contexts read FSM data through GetSnapshot() which
+ * retries until no update ran during the read.
  */
 class ResetController : ISubscriber
 {
@@ -65,12 +116,109 @@ public:
 	*/
 	_virtual Response DisableHardReset();
 
+	/**
+	* \brief Re-arm monitoring on the first ping received after reset.
+	*/
+	_virtual Response EnableAutoRearm();
+
+	/**
+	* \brief Wait for reboot timeout after reset regardless of pings.
+	*/
+	_virtual Response DisableAutoRearm();
+
+	/**
+	 * \brief Get time elapsed between the last reset and the ping that re-armed monitoring, ms.
+	 */
+	_virtual uint32_t GetLastBootDuration();
+
+	/**
+	 * \brief Configure adaptive reboot timeout: mean boot duration plus factor deviations.
+	 * \param factor Deviation factor (0-15), 0 disables adaptive reboot timeout.
+	 * \param min Least reboot timeout, same encoding as SetRebootTimeout.
+	 * \param max Greatest reboot timeout, same encoding as SetRebootTimeout.
+	 */
+	_virtual Response SetAdaptiveReboot(uint8_t factor, uint8_t min, uint8_t max);
+
+	/**
+	 * \brief Store adaptive reboot settings and learned statistics into buffer.
+	 * \param data Buffer ADAPTIVE_REBOOT_SIZE bytes long.
+	 */
+	_virtual void ExportAdaptiveReboot(uint8_t* data);
+
+	/**
+	 * \brief Restore adaptive reboot settings and learned statistics from buffer.
+	 * \param data Buffer ADAPTIVE_REBOOT_SIZE bytes long.
+	 */
+	_virtual void ImportAdaptiveReboot(const uint8_t* data);
+
+	/**
+	 * \brief Get reboot timeout currently in effect, ms.
+	 */
+	_virtual uint32_t GetRebootTimeout();
+
+	/**
+	 * \brief Restore soft and hard resets counted since factory reset.
+	 * \param soft Soft resets count.
+	 * \param hard Hard resets count, power pulses included.
+	 */
+	_virtual void ImportResetCounters(uint32_t soft, uint32_t hard);
+
+	/**
+	 * \brief Get pings received since power on.
+	 */
+	_virtual uint32_t GetPings();
+
+	/**
+	 * \brief Get boot duration moving average, ms.
+	 */
+	_virtual uint32_t GetBootMean();
+
+	/**
+	 * \brief Get boot duration moving mean deviation, ms.
+	 */
+	_virtual uint32_t GetBootDeviation();
+
+	/**
+	 * \brief Get boot durations count learned since power on (saturates at 255).
+	 */
+	_virtual uint8_t GetBootSamples();
+
+	/**
+	 * \brief Get adaptive reboot deviation factor, 0 if adaptive reboot timeout disabled.
+	 */
+	_virtual uint8_t GetAdaptiveFactor();
+
+	/**
+	 * \brief Set activity input timeout, no activity edges during timeout counts as host hang.
+	 * \param timeout Timeout in 5 s units (0-63), 0 disables activity monitoring.
+	 */
+	_virtual Response SetActivityTimeout(uint8_t timeout);
+
+	/**
+	 * \brief Get activity input edges counted during the last complete window.
+	 * \remarks Saturates at 255 edges.
+	 */
+	_virtual uint8_t GetActivityEdges();
+
 	/**
 	 * \brief Ping watchdog.
 	 * \remarks see https://hwdg.ru/hardware-watchdog-api/ping/ for more details.
 	 */
 	_virtual Response Ping();
 
+	/**
+	 * \brief Take consistent copy of data timer interrupt updates.
+	 * \param snapshot Snapshot to fill.
+	 */
+	_virtual void GetSnapshot(ResetSnapshot& snapshot);
+
+#ifdef _M_IX86
+	/**
+	 * \brief Host builds call it between snapshot reads to simulate timer interrupt.
+	 */
+	static void (*preemption)();
+#endif
+
 	/**
 	 * \brief Set response timeout.
 	 * \param timeout Timeout (0-59).
@@ -119,11 +267,39 @@ public:
 	*/
 	_virtual Response DisableEvents();
 
+	/**
+	* \brief Enable framed reset controller event stream.
+	* \param period WatchdogOk heartbeat period in seconds, 0 disables heartbeat.
+	* \remarks Mode and period survive reboot once settings are saved.
+	*/
+	_virtual Response SetEventStream(uint8_t period);
+
 	/**
 	* \brief Determine if reset controller evets enabled.
 	*/
 	_virtual bool IsEventsEnabled();
 
+	/**
+	* \brief Determine if reset controller events are sent as framed stream.
+	* \param period WatchdogOk heartbeat period in seconds of the stream.
+	*/
+	_virtual bool IsEventStream(uint8_t& period);
+
+	/**
+	 * \brief Set escalation program stage.
+	 * \param index Stage index (0 - ESCALATION_STAGES-1).
+	 * \param action Stage action (bits 7-6) and repeat count minus one (bits 5-0).
+	 * \param duration Delay after each action in 5 s units, 0 means reboot timeout.
+	 * \remarks Stage with both action and duration equal to zero terminates the program.
+	 * Empty program runs default soft reset/hard reset sequence.
+	 */
+	_virtual Response SetEscalationStage(uint8_t index, uint8_t action, uint8_t duration);
+
+	/**
+	 * \brief Get escalation program (two bytes per stage).
+	 */
+	_virtual const uint8_t* GetEscalation();
+
 	/**
 	 * \brief Get rebooter reference.
 	 */
@@ -135,12 +311,22 @@ public:
 	_virtual LedController& GetLedController();
 private:
 	void Callback(uint8_t data) _override;
-	bool eventsEnabled;
-	Uart& uart;
+	void Run();
+	void OnPing();
+	bool ChangeIdleState(uint8_t set, uint8_t clear);
+	static uint32_t GetRearmTimeout(uint32_t deadline);
+	void Escalate(bool first);
+	void MoveToIdle();
+	void LearnBootDuration(uint32_t duration);
+	void ResetActivity();
+	void IssueSoftReset();
+	void IssueHardReset(bool pulse);
+	uint32_t GetTimeUntilAction(const ResetSnapshot& snapshot);
+	void SampleActivity();
+	EventChannel events;
 	Rebooter& rebooter;
 	LedController& ledController;
 	uint32_t counter;
-	uint16_t counterms;
 	uint_least8_t state;
 	uint32_t responseTimeout;
 	uint32_t rebootTimeout;
@@ -148,4 +334,29 @@ private:
 	uint8_t hAttempt;
 	uint8_t sAttemptCurr;
 	uint8_t hAttemptCurr;
+	uint8_t escalation[ESCALATION_SIZE];
+	uint8_t stage;
+	uint8_t stageRepeat;
+	uint32_t stageTimeout;
+	uint32_t bootDuration;
+	uint32_t bootMean;
+	uint32_t bootDeviation;
+	uint8_t bootSamples;
+	uint8_t adaptiveFactor;
+	uint8_t adaptiveMin;
+	uint8_t adaptiveMax;
+	uint32_t activityTimeout;
+	uint32_t activityIdle;
+	uint16_t activityWindow;
+	uint16_t activityLast;
+	uint8_t activityEdges;
+	volatile uint16_t version;
+	volatile uint8_t pingRequest;
+	uint32_t uptime;
+	uint32_t lastPing;
+	uint32_t pings;
+	uint16_t softResets;
+	uint16_t hardResets;
+	uint32_t totalSoftResets;
+	uint32_t totalHardResets;
 };
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+// Shared with HwdgTiny C sources, keep it valid C.
 enum Response
 {
 	Busy = 0x20,
@@ -43,6 +44,12 @@ enum Response
 
 	SaveSettingsError = 0x47,
 	PowerPulseOk = 0x48,
+	SetEscalationStageOk = 0x49,
+	EnableAutoRearmOk = 0x4A,
+	DisableAutoRearmOk = 0x4B,
+	SetAdaptiveRebootOk = 0x4C,
+	SetActivityTimeoutOk = 0x4D,
+	SetEventStreamOk = 0x4E,
 
 	UnknownCommand = 0x4F,
 
@@ -52,4 +59,7 @@ enum Response
 	MovedToIdle = 0x33,
 	WatchdogOk = 0x34,
 	SoftwareVersion = 0x55,
+	TaggedResponse = 0x56,
+	SetBusAddressOk = 0x57,
+	InvalidArgument = 0x58,
 };
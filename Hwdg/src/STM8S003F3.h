@@ -287,6 +287,38 @@ typedef struct
 #define CFG_GCR_AL               CFG_GCR_AL_Msk
 
 
+/*======================================================================
+*      Reset status register (RST_SR)
+*=======================================================================*/
+typedef struct
+{
+	volatile unsigned char SR;
+} RstTypedef;
+
+#define RST_BASE               (0x0050B3)
+
+#define RST                    ((RstTypedef *) RST_BASE)
+
+#define RST_SR_WWDGF_Pos       (0U)
+#define RST_SR_WWDGF_Msk       (0x1U << RST_SR_WWDGF_Pos)
+#define RST_SR_WWDGF           RST_SR_WWDGF_Msk
+
+#define RST_SR_IWDGF_Pos       (1U)
+#define RST_SR_IWDGF_Msk       (0x1U << RST_SR_IWDGF_Pos)
+#define RST_SR_IWDGF           RST_SR_IWDGF_Msk
+
+#define RST_SR_ILLOPF_Pos      (2U)
+#define RST_SR_ILLOPF_Msk      (0x1U << RST_SR_ILLOPF_Pos)
+#define RST_SR_ILLOPF          RST_SR_ILLOPF_Msk
+
+#define RST_SR_SWIMF_Pos       (3U)
+#define RST_SR_SWIMF_Msk       (0x1U << RST_SR_SWIMF_Pos)
+#define RST_SR_SWIMF           RST_SR_SWIMF_Msk
+
+#define RST_SR_EMCF_Pos        (4U)
+#define RST_SR_EMCF_Msk        (0x1U << RST_SR_EMCF_Pos)
+#define RST_SR_EMCF            RST_SR_EMCF_Msk
+
 /*======================================================================
 *      WWDG
 *=======================================================================*/
@@ -23,11 +23,94 @@ uint8_t __eeprom settings0 = SETTINGS_DEFAULT_0;
 uint8_t __eeprom settings1 = SETTINGS_DEFAULT_1;
 uint8_t __eeprom settings2 = SETTINGS_DEFAULT_2;
 uint8_t __eeprom settings3 = SETTINGS_DEFAULT_3;
+uint8_t __eeprom escalation[ESCALATION_SIZE];
+uint8_t __eeprom adaptiveReboot[ADAPTIVE_REBOOT_SIZE];
+uint8_t __eeprom resetCounters[COUNTERS_SIZE];
+uint8_t __eeprom resetCauses[CAUSES_SIZE];
+uint8_t __eeprom busAddress;
+uint8_t __eeprom eventStream[EVENT_STREAM_SIZE];
+typedef uint8_t __eeprom* NvramAddress;
 #endif
 #ifdef __AVR__
 #include <EEPROM.h>
 #include <Arduino.h>
 const uint8_t CompileTime[] PROGMEM = __DATE__ " " __TIME__;
+#define ESCALATION_ADDR   (sizeof CompileTime + 5)
+#define ADAPTIVE_ADDR     (ESCALATION_ADDR + ESCALATION_SIZE)
+#define COUNTERS_ADDR     (ADAPTIVE_ADDR + ADAPTIVE_REBOOT_SIZE)
+#define CAUSES_ADDR       (COUNTERS_ADDR + COUNTERS_SIZE)
+#define BUS_ADDR          (CAUSES_ADDR + CAUSES_SIZE)
+#define STREAM_ADDR       (BUS_ADDR + 1)
+typedef int NvramAddress;
+#endif
+
+#if defined(__ICCSTM8__) || defined(__AVR__)
+/**
+ * \brief Write data block into EEPROM skipping bytes that hold the same value.
+ * \return Returns true if write operation succeeded, otherwise false.
+ */
+static bool WriteBlock(NvramAddress dst, const uint8_t* src, uint8_t length)
+{
+	uint8_t i;
+#ifdef __ICCSTM8__
+	// If we have the same values in EEPROM we don't need to
+	// rewrite existing data, just say operation succeeded.
+	for (i = 0; i < length && dst[i] == src[i]; i++)
+		;
+	if (i == length)
+		return true;
+
+	// Write data to EEPROM.
+	FLASH->DUKR = FLASH_RASS_KEY1;
+	FLASH->DUKR = FLASH_RASS_KEY2;
+	for (i = 0; i < length; i++)
+		if (dst[i] != src[i]) dst[i] = src[i];
+	FLASH->IAPSR = uint8_t(~FLASH_IAPSR_DUL);
+
+	// Verify write operation succeeded.
+	for (i = 0; i < length; i++)
+		if (dst[i] != src[i]) return false;
+#endif
+#ifdef __AVR__
+	// EEPROM.update() skips bytes that already hold the same value.
+	for (i = 0; i < length; i++)
+		EEPROM.update(dst + i, src[i]);
+
+	// Verify write operation succeeded.
+	for (i = 0; i < length; i++)
+		if (EEPROM[dst + i] != src[i]) return false;
+#endif
+	return true;
+}
+
+/**
+ * \brief Determine if every byte of EEPROM data block is zero.
+ */
+static bool IsBlank(NvramAddress src, uint8_t length)
+{
+	for (uint8_t i = 0; i < length; i++)
+#ifdef __ICCSTM8__
+		if (src[i]) return false;
+#endif
+#ifdef __AVR__
+		if (EEPROM[src + i]) return false;
+#endif
+	return true;
+}
+
+/**
+ * \brief Read data block from EEPROM.
+ */
+static void ReadBlock(NvramAddress src, uint8_t* dst, uint8_t length)
+{
+	for (uint8_t i = 0; i < length; i++)
+#ifdef __ICCSTM8__
+		dst[i] = src[i];
+#endif
+#ifdef __AVR__
+		dst[i] = EEPROM[src + i];
+#endif
+}
 #endif
 
 SettingsManager::SettingsManager()
@@ -42,6 +125,9 @@ SettingsManager::SettingsManager()
 			EEPROM[sizeof CompileTime + 2] = SETTINGS_DEFAULT_1;
 			EEPROM[sizeof CompileTime + 3] = SETTINGS_DEFAULT_2;
 			EEPROM[sizeof CompileTime + 4] = SETTINGS_DEFAULT_3;
+			for (uint8_t i = 0; i < ESCALATION_SIZE + ADAPTIVE_REBOOT_SIZE + COUNTERS_SIZE + CAUSES_SIZE; i++)
+				EEPROM[ESCALATION_ADDR + i] = INITIAL;
+			EEPROM[BUS_ADDR] = INITIAL;
 
 			while (f = pgm_read_byte(p++)) EEPROM[e++] = f;
 			break;
@@ -283,6 +369,194 @@ uint32_t SettingsManager::ObtainUserSettings()
 #endif
 }
 
+bool SettingsManager::SaveEscalation(const uint8_t* program)
+{
+#ifdef __ICCSTM8__
+	return WriteBlock(escalation, program, ESCALATION_SIZE);
+#endif
+#ifdef _M_IX86
+	(void)program;
+	return true;
+#endif
+#ifdef __AVR__
+	return WriteBlock(ESCALATION_ADDR, program, ESCALATION_SIZE);
+#endif
+}
+
+void SettingsManager::ObtainEscalation(uint8_t* program)
+{
+#ifdef __ICCSTM8__
+	ReadBlock(escalation, program, ESCALATION_SIZE);
+#endif
+#ifdef _M_IX86
+	for (uint8_t i = 0; i < ESCALATION_SIZE; i++) program[i] = INITIAL;
+#endif
+#ifdef __AVR__
+	ReadBlock(ESCALATION_ADDR, program, ESCALATION_SIZE);
+#endif
+}
+
+bool SettingsManager::SaveAdaptiveReboot(const uint8_t* data)
+{
+#ifdef __ICCSTM8__
+	return WriteBlock(adaptiveReboot, data, ADAPTIVE_REBOOT_SIZE);
+#endif
+#ifdef _M_IX86
+	(void)data;
+	return true;
+#endif
+#ifdef __AVR__
+	return WriteBlock(ADAPTIVE_ADDR, data, ADAPTIVE_REBOOT_SIZE);
+#endif
+}
+
+void SettingsManager::ObtainAdaptiveReboot(uint8_t* data)
+{
+#ifdef __ICCSTM8__
+	ReadBlock(adaptiveReboot, data, ADAPTIVE_REBOOT_SIZE);
+#endif
+#ifdef _M_IX86
+	for (uint8_t i = 0; i < ADAPTIVE_REBOOT_SIZE; i++) data[i] = INITIAL;
+#endif
+#ifdef __AVR__
+	ReadBlock(ADAPTIVE_ADDR, data, ADAPTIVE_REBOOT_SIZE);
+#endif
+}
+
+bool SettingsManager::SaveResetCounters(uint32_t soft, uint32_t hard)
+{
+	uint8_t data[COUNTERS_SIZE];
+	for (uint8_t i = 0; i < COUNTERS_SIZE / 2; i++)
+	{
+		data[i] = uint8_t(soft >> (24 - i * 8));
+		data[i + COUNTERS_SIZE / 2] = uint8_t(hard >> (24 - i * 8));
+	}
+#ifdef __ICCSTM8__
+	return WriteBlock(resetCounters, data, COUNTERS_SIZE);
+#endif
+#ifdef _M_IX86
+	(void)data;
+	return true;
+#endif
+#ifdef __AVR__
+	return WriteBlock(COUNTERS_ADDR, data, COUNTERS_SIZE);
+#endif
+}
+
+void SettingsManager::ObtainResetCounters(uint32_t& soft, uint32_t& hard)
+{
+	uint8_t data[COUNTERS_SIZE];
+#ifdef __ICCSTM8__
+	ReadBlock(resetCounters, data, COUNTERS_SIZE);
+#endif
+#ifdef _M_IX86
+	for (uint8_t i = 0; i < COUNTERS_SIZE; i++) data[i] = INITIAL;
+#endif
+#ifdef __AVR__
+	ReadBlock(COUNTERS_ADDR, data, COUNTERS_SIZE);
+#endif
+	soft = hard = INITIAL;
+	for (uint8_t i = 0; i < COUNTERS_SIZE / 2; i++)
+	{
+		soft = soft << 8 | data[i];
+		hard = hard << 8 | data[i + COUNTERS_SIZE / 2];
+	}
+}
+
+bool SettingsManager::SaveResetCauses(const uint16_t* counters)
+{
+	uint8_t data[CAUSES_SIZE];
+	for (uint8_t i = 0; i < CAUSES_SIZE / 2; i++)
+	{
+		data[i * 2] = uint8_t(counters[i] >> 8);
+		data[i * 2 + 1] = uint8_t(counters[i]);
+	}
+#ifdef __ICCSTM8__
+	return WriteBlock(resetCauses, data, CAUSES_SIZE);
+#endif
+#ifdef _M_IX86
+	(void)data;
+	return true;
+#endif
+#ifdef __AVR__
+	return WriteBlock(CAUSES_ADDR, data, CAUSES_SIZE);
+#endif
+}
+
+void SettingsManager::ObtainResetCauses(uint16_t* counters)
+{
+	uint8_t data[CAUSES_SIZE];
+#ifdef __ICCSTM8__
+	ReadBlock(resetCauses, data, CAUSES_SIZE);
+#endif
+#ifdef _M_IX86
+	for (uint8_t i = 0; i < CAUSES_SIZE; i++) data[i] = INITIAL;
+#endif
+#ifdef __AVR__
+	ReadBlock(CAUSES_ADDR, data, CAUSES_SIZE);
+#endif
+	for (uint8_t i = 0; i < CAUSES_SIZE / 2; i++)
+		counters[i] = uint16_t(data[i * 2] << 8 | data[i * 2 + 1]);
+}
+
+bool SettingsManager::SaveBusAddress(uint8_t address)
+{
+#ifdef __ICCSTM8__
+	return WriteBlock(&busAddress, &address, 1);
+#endif
+#ifdef _M_IX86
+	(void)address;
+	return true;
+#endif
+#ifdef __AVR__
+	return WriteBlock(BUS_ADDR, &address, 1);
+#endif
+}
+
+uint8_t SettingsManager::ObtainBusAddress()
+{
+#ifdef __ICCSTM8__
+	return busAddress;
+#endif
+#ifdef _M_IX86
+	return INITIAL;
+#endif
+#ifdef __AVR__
+	return EEPROM[BUS_ADDR];
+#endif
+}
+
+bool SettingsManager::SaveEventStream(uint8_t stream, uint8_t period)
+{
+	const uint8_t data[EVENT_STREAM_SIZE] = {stream, period};
+#ifdef __ICCSTM8__
+	return WriteBlock(eventStream, data, EVENT_STREAM_SIZE);
+#endif
+#ifdef _M_IX86
+	(void)data;
+	return true;
+#endif
+#ifdef __AVR__
+	return WriteBlock(STREAM_ADDR, data, EVENT_STREAM_SIZE);
+#endif
+}
+
+void SettingsManager::ObtainEventStream(uint8_t& stream, uint8_t& period)
+{
+	uint8_t data[EVENT_STREAM_SIZE];
+#ifdef __ICCSTM8__
+	ReadBlock(eventStream, data, EVENT_STREAM_SIZE);
+#endif
+#ifdef _M_IX86
+	for (uint8_t i = 0; i < EVENT_STREAM_SIZE; i++) data[i] = INITIAL;
+#endif
+#ifdef __AVR__
+	ReadBlock(STREAM_ADDR, data, EVENT_STREAM_SIZE);
+#endif
+	stream = data[0];
+	period = data[1];
+}
+
 Response SettingsManager::ApplyUserSettingsAtStartup()
 {
 #ifdef __ICCSTM8__
@@ -367,7 +641,10 @@ bool SettingsManager::RestoreFactory()
 	if (settings0 == SETTINGS_DEFAULT_0 &&
 		settings1 == SETTINGS_DEFAULT_1 &&
 		settings2 == SETTINGS_DEFAULT_2 &&
-		settings3 == SETTINGS_DEFAULT_3)
+		settings3 == SETTINGS_DEFAULT_3 &&
+		IsBlank(escalation, ESCALATION_SIZE) &&
+		IsBlank(adaptiveReboot, ADAPTIVE_REBOOT_SIZE) &&
+		IsBlank(resetCounters, COUNTERS_SIZE) && IsBlank(resetCauses, CAUSES_SIZE))
 		return true;
 
 	// Write data to EEPROM.
@@ -377,6 +654,14 @@ bool SettingsManager::RestoreFactory()
 	settings1 = SETTINGS_DEFAULT_1;
 	settings2 = SETTINGS_DEFAULT_2;
 	settings3 = SETTINGS_DEFAULT_3;
+	for (uint8_t i = 0; i < ESCALATION_SIZE; i++)
+		if (escalation[i]) escalation[i] = INITIAL;
+	for (uint8_t i = 0; i < ADAPTIVE_REBOOT_SIZE; i++)
+		if (adaptiveReboot[i]) adaptiveReboot[i] = INITIAL;
+	for (uint8_t i = 0; i < COUNTERS_SIZE; i++)
+		if (resetCounters[i]) resetCounters[i] = INITIAL;
+	for (uint8_t i = 0; i < CAUSES_SIZE; i++)
+		if (resetCauses[i]) resetCauses[i] = INITIAL;
 	FLASH->IAPSR = uint8_t(~FLASH_IAPSR_DUL);
 
 	// Verify write operation succeeded.
@@ -394,7 +679,10 @@ bool SettingsManager::RestoreFactory()
 	if (EEPROM[sizeof CompileTime + 1] == SETTINGS_DEFAULT_0 &&
 		EEPROM[sizeof CompileTime + 2] == SETTINGS_DEFAULT_1 &&
 		EEPROM[sizeof CompileTime + 3] == SETTINGS_DEFAULT_2 &&
-		EEPROM[sizeof CompileTime + 4] == SETTINGS_DEFAULT_3)
+		EEPROM[sizeof CompileTime + 4] == SETTINGS_DEFAULT_3 &&
+		IsBlank(ESCALATION_ADDR, ESCALATION_SIZE) &&
+		IsBlank(ADAPTIVE_ADDR, ADAPTIVE_REBOOT_SIZE) &&
+		IsBlank(COUNTERS_ADDR, COUNTERS_SIZE) && IsBlank(CAUSES_ADDR, CAUSES_SIZE))
 		return true;
 
 	// Write data to EEPROM.
@@ -402,6 +690,8 @@ bool SettingsManager::RestoreFactory()
 	EEPROM[sizeof CompileTime + 2] = SETTINGS_DEFAULT_1;
 	EEPROM[sizeof CompileTime + 3] = SETTINGS_DEFAULT_2;
 	EEPROM[sizeof CompileTime + 4] = SETTINGS_DEFAULT_3;
+	for (uint8_t i = 0; i < ESCALATION_SIZE + ADAPTIVE_REBOOT_SIZE + COUNTERS_SIZE + CAUSES_SIZE; i++)
+		EEPROM.update(ESCALATION_ADDR + i, INITIAL);
 
 	// Verify write operation succeeded.
 	return EEPROM[sizeof CompileTime + 1] == SETTINGS_DEFAULT_0 &&
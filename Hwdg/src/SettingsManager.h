@@ -14,6 +14,7 @@
 
 #pragma once
 #include "PlatformDefinitions.h"
+#include "ResetController.h"
 #include "Response.h"
 #include <stdint.h>
 
@@ -22,12 +23,23 @@
 #define SETTINGS_DEFAULT_2            ((uint8_t)0x48)
 #define SETTINGS_DEFAULT_3            ((uint8_t)0x00)
 
+// Settings byte 0 flag
+#define AUTO_REARM_ENABLED            ((uint8_t)(1U << 7U))
+
+// Settings byte 3 flags
 #define LED_DISABLED                  ((uint8_t)(1U << 0U))
 #define EVENTS_ENABLED                ((uint8_t)(1U << 1U))
 #define APPLY_SETTINGS_AT_STARTUP     ((uint8_t)(1U << 2U))
 #define RST_PULSE_ENABLED             ((uint8_t)(1U << 3U))
 #define PWR_PULSE_ENABLED             ((uint8_t)(1U << 4U))
 
+// Lifetime reset counters size stored in NVRAM, bytes (soft and hard, 4 bytes each)
+#define COUNTERS_SIZE                 ((uint8_t)8U)
+// Chip reset cause counters size stored in NVRAM, bytes (2 bytes per cause)
+#define CAUSES_SIZE                   ((uint8_t)16U)
+// Event stream settings size stored in NVRAM, bytes (stream flag and heartbeat period)
+#define EVENT_STREAM_SIZE             ((uint8_t)2U)
+
 /**
  * \brief Represents settings manager that saves and obtains settings stored in NVRAM.
  */
@@ -76,6 +88,87 @@ public:
 	 */
 	_virtual uint32_t ObtainUserSettings();
 
+	/**
+	 * \brief Save escalation program into NVRAM.
+	 * \param program Program to be saved (ESCALATION_SIZE bytes).
+	 * \return Returns true if save operation succeeded, otherwise false.
+	 */
+	_virtual bool SaveEscalation(const uint8_t* program);
+
+	/**
+	 * \brief Fetch escalation program from NVRAM.
+	 * \param program Buffer to store program (ESCALATION_SIZE bytes).
+	 */
+	_virtual void ObtainEscalation(uint8_t* program);
+
+	/**
+	 * \brief Save adaptive reboot settings and learned boot statistics into NVRAM.
+	 * \param data Data to be saved (ADAPTIVE_REBOOT_SIZE bytes).
+	 * \return Returns true if save operation succeeded, otherwise false.
+	 */
+	_virtual bool SaveAdaptiveReboot(const uint8_t* data);
+
+	/**
+	 * \brief Fetch adaptive reboot settings and learned boot statistics from NVRAM.
+	 * \param data Buffer to store data (ADAPTIVE_REBOOT_SIZE bytes).
+	 */
+	_virtual void ObtainAdaptiveReboot(uint8_t* data);
+
+	/**
+	 * \brief Save resets counted since factory reset into NVRAM.
+	 * \param soft Soft resets count.
+	 * \param hard Hard resets count.
+	 * \return Returns true if save operation succeeded, otherwise false.
+	 */
+	_virtual bool SaveResetCounters(uint32_t soft, uint32_t hard);
+
+	/**
+	 * \brief Fetch resets counted since factory reset from NVRAM.
+	 * \param soft Soft resets count.
+	 * \param hard Hard resets count.
+	 */
+	_virtual void ObtainResetCounters(uint32_t& soft, uint32_t& hard);
+
+	/**
+	 * \brief Save chip reset cause counters into NVRAM.
+	 * \param counters Counters to be saved (CAUSES_SIZE / 2 items).
+	 * \return Returns true if save operation succeeded, otherwise false.
+	 */
+	_virtual bool SaveResetCauses(const uint16_t* counters);
+
+	/**
+	 * \brief Fetch chip reset cause counters from NVRAM.
+	 * \param counters Buffer to store counters (CAUSES_SIZE / 2 items).
+	 */
+	_virtual void ObtainResetCauses(uint16_t* counters);
+
+	/**
+	 * \brief Save multi-drop bus address into NVRAM.
+	 * \param address Board address, 0 disables bus mode.
+	 * \return Returns true if save operation succeeded, otherwise false.
+	 * \remarks Address survives factory reset, otherwise the board would drop off the bus.
+	 */
+	_virtual bool SaveBusAddress(uint8_t address);
+
+	/**
+	 * \brief Fetch multi-drop bus address from NVRAM.
+	 */
+	_virtual uint8_t ObtainBusAddress();
+
+	/**
+	 * \brief Save event stream settings into NVRAM.
+	 * \param stream Non-zero if events are sent as framed stream rather than single bytes.
+	 * \param period WatchdogOk heartbeat period in seconds.
+	 * \return Returns true if save operation succeeded, otherwise false.
+	 * \remarks Applied only along with EVENTS_ENABLED flag, so factory reset leaves them.
+	 */
+	_virtual bool SaveEventStream(uint8_t stream, uint8_t period);
+
+	/**
+	 * \brief Fetch event stream settings from NVRAM.
+	 */
+	_virtual void ObtainEventStream(uint8_t& stream, uint8_t& period);
+
 	/**
 	 * \brief Apply user settings at startup.
 	 * \return Returns operation status.
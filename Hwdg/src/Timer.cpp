@@ -38,6 +38,7 @@ ISubscriber* Timer::subscribers[MAX_TIMER_SUBSCRIBERS] = { nullptr, nullptr, nul
 #else
 #error Too much subscribers defined!
 #endif
+volatile uint16_t Timer::ticks = 0;
 
 void Timer::Run()
 {
@@ -56,21 +57,8 @@ void Timer::Run()
 #endif
 #ifdef __ICCSTM8__
 	// Set TIM4 overflow interrupt every 1 ms.
-	switch (Clock::GetCpuFreq())
-	{
-	case Freq2Mhz:
-		TIM4->PSCR = 0x04;
-		break;
-	case Freq4Mhz:
-		TIM4->PSCR = 0x05;
-		break;
-	case Freq8Mhz:
-		TIM4->PSCR = 0x06;
-		break;
-	case Freq16Mhz:
-		TIM4->PSCR = 0x07;
-		break;
-	}
+	// Master clock divided by 128 gives 125 kHz counter clock.
+	TIM4->PSCR = 0x07;
 	TIM4->ARR = ARR_VAL;
 	TIM4->IER &= ~TIM4_IER_UIE;
 	TIM4->CR1 = TIM4_CR1_CEN;
@@ -122,6 +110,17 @@ void Timer::UnsubscribeOnElapse(ISubscriber& sbcr)
 	}
 }
 
+uint16_t Timer::GetTicks()
+{
+#ifdef __AVR__
+	// Arduino core reads its counter with interrupts disabled.
+	return uint16_t(millis());
+#else
+	// STM8 loads 16-bit value with single instruction, so read is atomic.
+	return ticks;
+#endif
+}
+
 #ifdef __AVR__
 ISR(TIMER1_COMPA_vect)
 {
@@ -137,6 +136,7 @@ __interrupt void Timer::OnElapse()
 #ifdef __ICCSTM8__
 	TIM4->SR &= ~TIM4_SR_UIF;
 #endif
+	ticks++;
 	for (uint_fast8_t i = 0; i < MAX_TIMER_SUBSCRIBERS; i++)
 		if (subscribers[i] != nullptr) subscribers[i]->Callback(0);
 }
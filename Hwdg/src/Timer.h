@@ -17,7 +17,7 @@
 #include "ISubscriber.h"
 
 #ifndef MAX_TIMER_SUBSCRIBERS
-#define MAX_TIMER_SUBSCRIBERS 4
+#define MAX_TIMER_SUBSCRIBERS 5
 #endif
 
 /**
@@ -56,11 +56,17 @@ public:
 	*/
 	_virtual void UnsubscribeOnElapse(ISubscriber& sbcr);
 
+	/**
+	* \brief Get milliseconds elapsed since power on, wraps around every 65.5 s.
+	* \remarks Safe to call from both interrupt and main loop contexts.
+	*/
+	static uint16_t GetTicks();
+
 	/**
 	 * \brief Occures on timer elapse.
 	 */
 	__interrupt static void OnElapse();
 private:
-
 	static ISubscriber* subscribers[MAX_TIMER_SUBSCRIBERS];
+	static volatile uint16_t ticks;
 };
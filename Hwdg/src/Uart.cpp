@@ -21,13 +21,36 @@
 
 #ifdef _M_IX86
 #define UART_REGISTER 5
+static uint8_t rxData = UART_REGISTER;
 #endif
 
 #ifdef __AVR__
 #include "Arduino.h"
+// Gap between bytes treated as idle line, ms
+#define BUS_IDLE_GAP ((uint32_t)3U)
+static uint32_t lastByteTime;
 #endif
 
+// Bus frame parser states
+#define FRAME_MARKER        ((uint8_t)0x00U)
+#define FRAME_ADDRESS       ((uint8_t)0x01U)
+#define FRAME_LENGTH        ((uint8_t)0x02U)
+#define FRAME_PAYLOAD       ((uint8_t)0x03U)
+#define FRAME_FOREIGN       ((uint8_t)0x04U)
+#define FRAME_SKIP          ((uint8_t)0x05U)
+
+// Transmit queue index mask
+#define TX_MASK ((uint8_t)(UART_TX_BUFFER_SIZE - 1))
+
 ISubscriber* Uart::subscriber = nullptr;
+uint8_t Uart::txBuffer[UART_TX_BUFFER_SIZE];
+volatile uint8_t Uart::txHead = 0;
+volatile uint8_t Uart::txTail = 0;
+uint8_t Uart::address = 0;
+uint8_t Uart::frameState = FRAME_MARKER;
+uint8_t Uart::frameTarget = 0;
+uint8_t Uart::frameRemaining = 0;
+bool Uart::txEnabled = true;
 
 Uart::Uart(uint32_t baudrate)
 {
@@ -39,10 +62,9 @@ Uart::Uart(uint32_t baudrate)
 	GPIOD->CR1 &= ~(1 << 6);
 	GPIOD->CR2 &= ~(1 << 6);
 
-	// Baudrate configuration.
-	uint32_t brr = Clock::GetCpuFreq() / baudrate;
-	UART1->BRR2 = brr & 0x000F;
-	UART1->BRR2 |= brr >> 12;
+	// Baudrate configuration, BRR2 must be written first.
+	uint32_t brr = MASTER_FREQ / baudrate;
+	UART1->BRR2 = (brr & 0x000F) | (brr >> 8 & 0x00F0);
 	UART1->BRR1 = (brr >> 4) & 0x00FF;
 
 	// UART configuration.
@@ -74,10 +96,16 @@ void Uart::UnsubscribeOnByteReceived()
 
 void Uart::SendByte(uint8_t data)
 {
+	// Bus is shared, unsolicited data and responses to broadcast would collide.
+	if (!txEnabled) return;
 #ifdef __ICCSTM8__
-	while (!(UART1->SR & UART_SR_TXE))
-		;
-	UART1->DR = data;
+	// Queued response lets receive interrupt return before the response
+	// is sent, so the host may send next command right away.
+	const uint8_t next = (txHead + 1) & TX_MASK;
+	while (next == txTail) TransmitNext();
+	txBuffer[txHead] = data;
+	txHead = next;
+	UART1->CR2 |= UART_CR2_TIEN;
 #endif
 #ifdef __AVR__
 	Serial.write(data);
@@ -86,6 +114,7 @@ void Uart::SendByte(uint8_t data)
 
 void Uart::SendData(uint8_t* data, uint8_t len)
 {
+	if (!txEnabled) return;
 #ifdef __ICCSTM8__
 	while (len--) SendByte(*data++);
 #endif
@@ -94,6 +123,58 @@ void Uart::SendData(uint8_t* data, uint8_t len)
 #endif
 }
 
+bool Uart::IsTxIdle()
+{
+#ifdef __ICCSTM8__
+	return txHead == txTail && UART1->SR & UART_SR_TC;
+#endif
+#ifdef _M_IX86
+	return true;
+#endif
+#ifdef __AVR__
+	return Serial.availableForWrite() >= SERIAL_TX_BUFFER_SIZE - 1;
+#endif
+}
+
+bool Uart::IsBusMode()
+{
+	return address != 0;
+}
+
+void Uart::SetBusAddress(uint8_t address)
+{
+	Uart::address = address;
+	frameState = FRAME_MARKER;
+	txEnabled = !address;
+#ifdef __ICCSTM8__
+	// Idle line separates bus frames.
+	address
+		? UART1->CR2 |= UART_CR2_ILIEN
+		: UART1->CR2 &= ~UART_CR2_ILIEN;
+#endif
+}
+
+void Uart::TransmitNext()
+{
+#ifdef __ICCSTM8__
+	if (!(UART1->SR & UART_SR_TXE)) return;
+	if (txHead == txTail)
+	{
+		UART1->CR2 &= ~UART_CR2_TIEN;
+		return;
+	}
+	UART1->DR = txBuffer[txTail];
+	txTail = (txTail + 1) & TX_MASK;
+#endif
+}
+
+#ifdef __ICCSTM8__
+#pragma vector=UART1_T_TXE_ISR
+#endif
+__interrupt void Uart::OnTxEmpty()
+{
+	TransmitNext();
+}
 
 #ifdef __AVR__
 void serialEvent()
@@ -106,14 +187,80 @@ void serialEvent()
 #endif
 __interrupt void Uart::OnByteReceived()
 {
-	if (subscriber == nullptr) return;
 #ifdef __ICCSTM8__
-	subscriber->Callback(UART1->DR);
+	// Idle line interrupt shares the vector, reading DR clears both flags.
+	const uint8_t status = UART1->SR;
+	const uint8_t data = UART1->DR;
+	if (status & UART_SR_RXNE)
+	{
+		if (!address) Deliver(data);
+		else Filter(data);
+	}
+	if (status & UART_SR_IDLE) frameState = FRAME_MARKER;
 #endif
 #ifdef _M_IX86
-	subscriber->Callback(UART_REGISTER);
+	if (!address) Deliver(rxData);
+	else Filter(rxData);
 #endif
 #ifdef __AVR__
-	subscriber->Callback(Serial.read());
+	// No idle line detection, long enough gap between bytes does the same.
+	const uint32_t now = millis();
+	if (now - lastByteTime > BUS_IDLE_GAP) frameState = FRAME_MARKER;
+	lastByteTime = now;
+	const uint8_t data = Serial.read();
+	if (!address) Deliver(data);
+	else Filter(data);
 #endif
 }
+
+void Uart::Filter(uint8_t data)
+{
+	switch (frameState)
+	{
+	case FRAME_MARKER:
+		// Anything else is response of another board, skip it until idle line.
+		frameState = data == BUS_MARKER ? FRAME_ADDRESS : FRAME_SKIP;
+		break;
+	case FRAME_ADDRESS:
+		frameTarget = data;
+		frameState = FRAME_LENGTH;
+		break;
+	case FRAME_LENGTH:
+		frameRemaining = data;
+		frameState = !data
+			? FRAME_MARKER
+			: frameTarget == address || frameTarget == BUS_BROADCAST
+			? FRAME_PAYLOAD
+			: FRAME_FOREIGN;
+		break;
+	case FRAME_PAYLOAD:
+		// Frames may follow each other without idle line, so count payload.
+		if (!--frameRemaining) frameState = FRAME_MARKER;
+		txEnabled = frameTarget != BUS_BROADCAST;
+		Deliver(data);
+		txEnabled = false;
+		break;
+	case FRAME_FOREIGN:
+		if (!--frameRemaining) frameState = FRAME_MARKER;
+		break;
+	default:
+		break;
+	}
+}
+
+void Uart::Deliver(uint8_t data)
+{
+	if (subscriber != nullptr) subscriber->Callback(data);
+}
+
+#ifdef _M_IX86
+void Uart::SimulateReceive(uint8_t data)
+{
+	rxData = data;
+}
+
+void Uart::SimulateIdleLine()
+{
+	frameState = FRAME_MARKER;
+}
+#endif
@@ -17,6 +17,16 @@
 #include "PlatformDefinitions.h"
 #include "ISubscriber.h"
 
+#ifndef UART_TX_BUFFER_SIZE
+// Transmit queue size, bytes (power of two)
+#define UART_TX_BUFFER_SIZE 64
+#endif
+
+// Bus frame marker: marker, address, payload length and payload follow
+#define BUS_MARKER          ((uint8_t)0xA6U)
+// Bus address every board accepts, boards don't respond to broadcast frames
+#define BUS_BROADCAST       ((uint8_t)0xFFU)
+
 class Uart
 {
 public:
@@ -44,8 +54,10 @@ public:
 	_virtual void UnsubscribeOnByteReceived();
 
 	/**
-	* \brief Send byte through the UART.
+	* \brief Queue byte to be sent through the UART.
 	* \param data Data to be sent.
+	* \remarks Call from interrupt context. Full queue is drained by polling,
+	* as transmit interrupt can't preempt the caller.
 	*/
 	_virtual void SendByte(uint8_t data);
 
@@ -56,10 +68,59 @@ public:
 	*/
 	_virtual void SendData(uint8_t* data, uint8_t len);
 
+	/**
+	* \brief Determine if transmitter has nothing left to send.
+	*/
+	_virtual bool IsTxIdle();
+
+	/**
+	* \brief Set multi-drop bus address.
+	* \param address Board address (1-254), 0 disables bus mode.
+	* \remarks In bus mode only payload of frames addressed to the board or broadcast
+	* reaches the subscriber, and data is sent only in response to own frames.
+	* Board skips bytes it can't parse until idle line, so the host must keep the
+	* line idle for at least 5 ms before every frame (one byte time on STM8,
+	* BUS_IDLE_GAP measured with 1 ms resolution on AVR).
+	*/
+	_virtual void SetBusAddress(uint8_t address);
+
+	/**
+	* \brief Determine if board is in multi-drop bus mode.
+	*/
+	static bool IsBusMode();
+
 	/**
 	 * \brief Executes when new byte received.
 	 */
 	__interrupt static void OnByteReceived();
+
+	/**
+	 * \brief Executes when transmit data register gets empty.
+	 */
+	__interrupt static void OnTxEmpty();
+
+#ifdef _M_IX86
+	/**
+	 * \brief Set byte host builds receive on OnByteReceived().
+	 */
+	static void SimulateReceive(uint8_t data);
+
+	/**
+	 * \brief Simulate idle line that separates bus frames.
+	 */
+	static void SimulateIdleLine();
+#endif
 private:
+	static void TransmitNext();
+	static void Filter(uint8_t data);
+	static void Deliver(uint8_t data);
+	static uint8_t address;
+	static uint8_t frameState;
+	static uint8_t frameTarget;
+	static uint8_t frameRemaining;
+	static bool txEnabled;
 	static ISubscriber* subscriber;
+	static uint8_t txBuffer[UART_TX_BUFFER_SIZE];
+	static volatile uint8_t txHead;
+	static volatile uint8_t txTail;
 };
@@ -0,0 +1,93 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * \brief Watchdog protocol core shared by Hwdg and HwdgTiny, header must stay valid C.
+ * \remarks Host sets timeouts in protocol units, so targets convert them
+ * into own timer ticks here rather than scale the units.
+ */
+
+#ifndef WDG_TICK_MS
+// Reset controller FSM tick period, ms
+#define WDG_TICK_MS            1UL
+#endif
+
+// Convert time into reset controller FSM ticks
+#define WDG_TICKS(ms)          ((uint32_t)(ms) / WDG_TICK_MS)
+
+// Soft reset time base, ticks
+#define SR_TIMEBASE            WDG_TICKS(5000UL)
+// Hard reset time base, ticks
+#define HR_TIMEBASE            WDG_TICKS(5000UL)
+// Least reboot timeout value, ticks
+#define REBOOT_MIN_TIMEOUT     WDG_TICKS(10000UL)
+// Soft reset pin low level duration, ticks
+#define RST_PULSE              WDG_TICKS(200UL)
+// Hard reset power pin low level duration, forces power off, ticks
+#define HR_OFF_PULSE           WDG_TICKS(6000UL)
+// Hard reset pause before power on pulse, ticks
+#define HR_ON_DELAY            WDG_TICKS(2000UL)
+
+// Mask applied to extract attempts value
+#define ATTEMPTS_MASK          ((uint8_t)0x07U)
+// Mask applied to extract reboot timeout value
+#define REBOOT_MASK            ((uint8_t)0x7FU)
+// Mask applied to extract response timeout value
+#define RESPONSE_MASK          ((uint8_t)0x3FU)
+
+// GetStatus command, answered with status bytes and checksum
+#define WDG_GET_STATUS         ((uint8_t)0x01U)
+
+/**
+ * \brief Decode SetResponseTimeout command argument into ticks.
+ */
+static inline uint32_t WdgResponseTimeout(uint8_t timeout)
+{
+	return ((timeout & RESPONSE_MASK) + 1) * SR_TIMEBASE;
+}
+
+/**
+ * \brief Decode SetRebootTimeout command argument into ticks.
+ */
+static inline uint32_t WdgRebootTimeout(uint8_t timeout)
+{
+	return REBOOT_MIN_TIMEOUT + (timeout & REBOOT_MASK) * HR_TIMEBASE;
+}
+
+/**
+ * \brief Decode SetSoftResetAttempts/SetHardResetAttempts command argument.
+ */
+static inline uint8_t WdgAttempts(uint8_t attempts)
+{
+	return (attempts & ATTEMPTS_MASK) + 1;
+}
+
+/**
+ * \brief Encode response timeout for GetStatus response.
+ */
+static inline uint8_t WdgResponseTimeoutCode(uint32_t timeout)
+{
+	return (uint8_t)(timeout / SR_TIMEBASE - 1);
+}
+
+/**
+ * \brief Encode reboot timeout for GetStatus response.
+ */
+static inline uint8_t WdgRebootTimeoutCode(uint32_t timeout)
+{
+	return (uint8_t)((timeout - REBOOT_MIN_TIMEOUT) / HR_TIMEBASE);
+}
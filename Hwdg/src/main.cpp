@@ -21,6 +21,7 @@
 #include "CommandManager.h"
 #include "GpioDriver.h"
 #include "BootManager.h"
+#include "FrequencyScaler.h"
 
 int main()
 {
@@ -33,6 +34,7 @@ int main()
 	Rebooter rebooter(timer, drw);
 	LedController ldCtr(timer, drw);
 	Uart uart(9600);
+	FrequencyScaler scaler(timer);
 	ResetController controller(uart, rebooter, ldCtr);
 
 #ifdef __ICCSTM8__
@@ -40,11 +42,12 @@ int main()
 #endif
 	
 	SettingsManager settingsManager;
-	BootManager btmgr(controller, settingsManager);
+	BootManager btmgr(controller, settingsManager, scaler);
 	btmgr.ProceedBoot();
-	CommandManager mgr(uart, controller, settingsManager);
+	uart.SetBusAddress(settingsManager.ObtainBusAddress());
+	CommandManager mgr(uart, controller, settingsManager, scaler);
 
 	for (;;)
-		;
+		btmgr.PersistResetCounters();
 }
 #endif
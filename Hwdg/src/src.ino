@@ -23,18 +23,21 @@ Timer timer;
 GpioDriver drw;
 Rebooter rebooter(timer, drw);
 LedController ldCtr(timer, drw);
+FrequencyScaler scaler(timer);
 ResetController controller(uart, rebooter, ldCtr);
 SettingsManager settingsManager;
-BootManager btmgr(controller, settingsManager);
-CommandManager mgr(uart, controller, settingsManager);
+BootManager btmgr(controller, settingsManager, scaler);
+CommandManager mgr(uart, controller, settingsManager, scaler);
 
 void setup()
 {
 	timer.Run();
 	btmgr.ProceedBoot();
+	uart.SetBusAddress(settingsManager.ObtainBusAddress());
 	Serial.begin(BAUDRATE);
 }
 
 void loop()
 {
+	btmgr.PersistResetCounters();
 }
@@ -46,6 +46,13 @@ namespace HwdgHid
         /// <returns>Returns report if read operation succeeded, otherwise returns null.</returns>
         Report GetReport(Byte reportId);
 
+        /// <summary>
+        /// Read next input report the device pushed through its interrupt-IN endpoint.
+        /// </summary>
+        /// <param name="timeout">Read timeout in milliseconds.</param>
+        /// <returns>Returns report if one arrived within <paramref name="timeout"/>, otherwise returns null.</returns>
+        Report ReadReport(Int32 timeout);
+
         /// <summary>
         /// Send feature report to the device.
         /// </summary>
@@ -17,7 +17,10 @@
 
 using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Linq;
+using System.Threading.Tasks;
+using Microsoft.Win32.SafeHandles;
 
 namespace HwdgHid.Win32
 {
@@ -27,6 +30,9 @@ namespace HwdgHid.Win32
     public class HidDevice : IHidDevice, IDisposable
     {
         private readonly IntPtr deviceHandle;
+        private FileStream inputStream;
+        private Task<Int32> pendingRead;
+        private Byte[] pendingBuffer;
 
         public HidDevice(DeviceInfo deviceInfo)
         {
@@ -66,6 +72,34 @@ namespace HwdgHid.Win32
                 : null;
         }
 
+        public Report ReadReport(Int32 timeout)
+        {
+            var length = Info.Capabilities.InputReportByteLength;
+            if (length <= 0) throw new NotSupportedException("The device not support input reports.");
+
+            if (inputStream == null)
+                inputStream = new FileStream(new SafeFileHandle(deviceHandle, false),
+                    System.IO.FileAccess.Read, length, true);
+
+            // Read that timed out stays pending and completes on the next call,
+            // so no report pushed by the device is lost.
+            if (pendingRead == null)
+            {
+                pendingBuffer = new Byte[length];
+                pendingRead = inputStream.ReadAsync(pendingBuffer, 0, length);
+            }
+
+            if (!pendingRead.Wait(timeout)) return null;
+
+            var read = pendingRead.Result;
+            var buff = pendingBuffer;
+            pendingRead = null;
+
+            return read > 0
+                ? new Report { Data = buff.Skip(1).Take(read - 1), ReportId = buff[0] }
+                : null;
+        }
+
         public void SendFeatureReport(Report report)
         {
             if (report == null) throw new NullReferenceException(nameof(report));
@@ -102,6 +136,7 @@ namespace HwdgHid.Win32
 
         public void Dispose()
         {
+            inputStream?.Dispose();
             ReleaseUnmanagedResources();
             GC.SuppressFinalize(this);
         }
@@ -0,0 +1,146 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "TinyEmulator.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "TinyFirmware.h"
+
+// bmRequestType of HID class requests to the interface
+#define REQUEST_TYPE_OUT       ((uint8_t)0x21U)
+#define REQUEST_TYPE_IN        ((uint8_t)0xA1U)
+// HID class requests
+#define HID_GET_REPORT         ((uint8_t)0x01U)
+#define HID_SET_REPORT         ((uint8_t)0x09U)
+// HID report types
+#define REPORT_TYPE_OUTPUT     ((uint8_t)0x02U)
+#define REPORT_TYPE_FEATURE    ((uint8_t)0x03U)
+// Restore factory command, restarts the chip through the watchdog
+#define RESTORE_FACTORY        ((uint8_t)0xF7U)
+// Reset line, PB3
+#define RST_VAL                ((uint8_t)(1U << 3U))
+// Power line, PB0
+#define PWR_VAL                ((uint8_t)(1U << 0U))
+
+TinyEmulator::TinyEmulator() :
+	fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+	TinyFirmwarePowerOn();
+	CollectReports();
+}
+
+TinyEmulator::~TinyEmulator()
+{
+	close(fd);
+}
+
+void TinyEmulator::Tick(uint32_t ms)
+{
+	while (ms--)
+	{
+		TinyFirmwareTick();
+		CollectReports();
+	}
+}
+
+bool TinyEmulator::IsResetAsserted() const
+{
+	return TinyFirmwareGetPins() & RST_VAL;
+}
+
+bool TinyEmulator::IsPowerAsserted() const
+{
+	return TinyFirmwareGetPins() & PWR_VAL;
+}
+
+int TinyEmulator::SendReport(const uint8_t* report, size_t length)
+{
+	// Firmware statics cannot be reinitialized, the device
+	// drops off the bus here anyway so the transfer fails
+	if (memchr(report + 1, RESTORE_FACTORY, length - 1) != nullptr)
+	{
+		errno = EPIPE;
+		return -1;
+	}
+
+	const uint8_t setup[8] = {
+		REQUEST_TYPE_OUT, HID_SET_REPORT, report[0], REPORT_TYPE_OUTPUT,
+		0, 0, (uint8_t)length, (uint8_t)(length >> 8)
+	};
+	const uint8_t result = TinyFirmwareControlOut(setup, report);
+	TinyFirmwarePoll();
+	CollectReports();
+	if (!result)
+	{
+		errno = EPIPE;
+		return -1;
+	}
+	return length;
+}
+
+int TinyEmulator::GetReport(uint8_t* report, size_t length)
+{
+	const uint8_t setup[8] = {
+		REQUEST_TYPE_IN, HID_GET_REPORT, report[0], REPORT_TYPE_FEATURE,
+		0, 0, (uint8_t)length, (uint8_t)(length >> 8)
+	};
+	const int result = TinyFirmwareControlIn(setup, report);
+	TinyFirmwarePoll();
+	CollectReports();
+	return result;
+}
+
+int TinyEmulator::ReadReport(uint8_t* report, size_t length)
+{
+	if (reports.empty())
+	{
+		errno = EAGAIN;
+		return -1;
+	}
+
+	const std::vector<uint8_t>& front = reports.front();
+	const size_t size = front.size() < length ? front.size() : length;
+	memcpy(report, front.data(), size);
+	reports.pop_front();
+
+	// Descriptor stays readable while reports are queued
+	if (reports.empty())
+	{
+		uint64_t counter;
+		(void)read(fd, &counter, sizeof(counter));
+	}
+	return size;
+}
+
+int TinyEmulator::GetFd() const
+{
+	return fd;
+}
+
+void TinyEmulator::CollectReports()
+{
+	// Report is taken as soon as it is queued, polling interval is not modelled
+	uint8_t report[8];
+	const uint8_t length = TinyFirmwareTakeInterrupt(report);
+	if (length == 0) return;
+
+	reports.emplace_back(report, report + length);
+	const uint64_t counter = 1;
+	(void)write(fd, &counter, sizeof(counter));
+}
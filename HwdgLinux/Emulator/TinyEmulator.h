@@ -0,0 +1,60 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <deque>
+#include <vector>
+#include "../src/IHidTransport.h"
+
+/**
+ * \brief HID report level stand-in for HWDG Tiny, reports go straight to
+ * HwdgTiny sources built for the host. Time moves only with Tick().
+ * \remarks Firmware keeps its state in statics, all instances share one chip.
+ */
+class TinyEmulator : public IHidTransport
+{
+public:
+	TinyEmulator();
+	~TinyEmulator();
+	TinyEmulator(const TinyEmulator&) = delete;
+	TinyEmulator& operator=(const TinyEmulator&) = delete;
+
+	/**
+	 * \brief Let the firmware run for a while.
+	 * \param ms Elapsed time in milliseconds.
+	 */
+	void Tick(uint32_t ms);
+
+	/**
+	 * \brief Determine if the firmware pulls reset line low.
+	 */
+	bool IsResetAsserted() const;
+
+	/**
+	 * \brief Determine if the firmware pulls power line low.
+	 */
+	bool IsPowerAsserted() const;
+
+	int SendReport(const uint8_t* report, size_t length) override;
+	int GetReport(uint8_t* report, size_t length) override;
+	int ReadReport(uint8_t* report, size_t length) override;
+	int GetFd() const override;
+private:
+	void CollectReports();
+	int fd;
+	std::deque<std::vector<uint8_t>> reports;
+};
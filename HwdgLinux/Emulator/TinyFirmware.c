@@ -0,0 +1,193 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "TinyFirmware.h"
+#include <string.h>
+#include "HardwareInit.h"
+#include "Common.h"
+#include "SettingsManager.h"
+
+// Registers of avr/io.h
+volatile uint8_t SREG;
+volatile uint8_t DDRB;
+volatile uint8_t PORTB;
+volatile uint8_t PINB;
+volatile uint8_t OSCCAL;
+volatile uint8_t MCUCR;
+volatile uint8_t GIMSK;
+volatile uint8_t GIFR;
+volatile uint8_t PCMSK;
+volatile uint8_t WDTCR;
+volatile uint8_t TIMSK;
+volatile uint8_t TCCR0A;
+volatile uint8_t TCCR0B;
+volatile uint8_t TCNT0;
+volatile uint8_t OCR0A;
+volatile uint8_t TCCR1;
+volatile uint8_t TCNT1;
+// Flags aren't cleared by writing one, so worst tick reads saturated
+volatile uint8_t TIFR;
+
+// Defined by main.c on the chip
+Status_t HwdgStatus;
+
+// Saved by HardwareInit.c on the chip, emulator starts from power-on
+uint8_t ResetFlags = _BV(PORF);
+
+// V-USB state the firmware touches
+usbMsgPtr_t usbMsgPtr;
+usbTxStatus_t usbTxStatus1;
+
+uint8_t TinyFirmwareEeprom[TINY_EEPROM_SIZE] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static uint8_t powered;
+
+extern void TIM0_COMPA_vect(void);
+
+void usbInit(void)
+{
+	usbTxLen1 = USBPID_NAK;
+}
+
+void usbPoll(void)
+{
+}
+
+void usbSetInterrupt(uchar* data, uchar len)
+{
+	memcpy(usbTxBuf1, data, len);
+	usbTxLen1 = len;
+}
+
+unsigned usbMeasureFrameLength(void)
+{
+	// Oscillator is always calibrated
+	return (unsigned)(1499 * (double)F_CPU / 10.5e6 + 0.5);
+}
+
+uint8_t eeprom_read_byte(const uint8_t* addr)
+{
+	return TinyFirmwareEeprom[(uintptr_t)addr];
+}
+
+uint32_t eeprom_read_dword(const uint32_t* addr)
+{
+	uint32_t value;
+	memcpy(&value, &TinyFirmwareEeprom[(uintptr_t)addr], sizeof(value));
+	return value;
+}
+
+void eeprom_write_byte(uint8_t* addr, uint8_t value)
+{
+	TinyFirmwareEeprom[(uintptr_t)addr] = value;
+}
+
+void eeprom_write_dword(uint32_t* addr, uint32_t value)
+{
+	memcpy(&TinyFirmwareEeprom[(uintptr_t)addr], &value, sizeof(value));
+}
+
+void eeprom_update_byte(uint8_t* addr, uint8_t value)
+{
+	eeprom_write_byte(addr, value);
+}
+
+void TinyFirmwarePowerOn(void)
+{
+	if (powered) return;
+	powered = 1;
+	// Devices ship with factory settings in EEPROM
+	if (eeprom_read_dword(0) == 0xFFFFFFFFU)
+		SettingsManagerRestoreFactory();
+	HardwareInit();
+}
+
+void TinyFirmwarePoll(void)
+{
+	UsbPoll();
+}
+
+void TinyFirmwareTick(void)
+{
+	TIM0_COMPA_vect();
+	UsbPoll();
+}
+
+/**
+ * \brief Unpack SETUP packet, V-USB words are wider than 16 bits on the
+ * host so the firmware gets the request in host layout.
+ */
+static usbRequest_t ParseSetup(const uint8_t setup[8])
+{
+	usbRequest_t rq;
+	memset(&rq, 0, sizeof(rq));
+	rq.bmRequestType = setup[0];
+	rq.bRequest = setup[1];
+	rq.wValue.word = setup[2] | setup[3] << 8;
+	rq.wIndex.word = setup[4] | setup[5] << 8;
+	rq.wLength.word = setup[6] | setup[7] << 8;
+	return rq;
+}
+
+uint16_t TinyFirmwareControlIn(const uint8_t setup[8], uint8_t* data)
+{
+	usbRequest_t rq = ParseSetup(setup);
+	const uint16_t requested = rq.wLength.word;
+
+	usbMsgLen_t length = usbFunctionSetup((uint8_t*)&rq);
+	if (length == USB_NO_MSG) return 0;
+	if (length > requested)
+		length = requested;
+	memcpy(data, (const void*)usbMsgPtr, length);
+	return length;
+}
+
+uint8_t TinyFirmwareControlOut(const uint8_t setup[8], const uint8_t* data)
+{
+	usbRequest_t rq = ParseSetup(setup);
+	const uint16_t length = rq.wLength.word;
+
+	if (usbFunctionSetup((uint8_t*)&rq) != USB_NO_MSG)
+		return 1;
+
+	for (uint16_t offset = 0; offset < length; offset += 8)
+	{
+		uint8_t chunk[8];
+		const uint8_t size = length - offset < 8 ? (uint8_t)(length - offset) : 8;
+		memcpy(chunk, data + offset, size);
+		const uint8_t result = usbFunctionWrite(chunk, size);
+		if (result == 0xFF) return 0;
+		if (result != 0) break;
+	}
+	return 1;
+}
+
+uint8_t TinyFirmwareTakeInterrupt(uint8_t* data)
+{
+	if (usbInterruptIsReady()) return 0;
+	const uint8_t length = usbTxLen1;
+	memcpy(data, usbTxBuf1, length);
+	usbTxLen1 = USBPID_NAK;
+	return length;
+}
+
+uint8_t TinyFirmwareGetPins(void)
+{
+	return DDRB;
+}
@@ -0,0 +1,88 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * \brief Host glue around HwdgTiny sources. It stands in for V-USB and the
+ * main loop, so the firmware sees the same calls it gets on the chip.
+ * \remarks Firmware keeps its state in statics, there is one emulated chip
+ * per process and it is powered on once.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Emulated EEPROM size, bytes
+#define TINY_EEPROM_SIZE 512
+
+/**
+ * \brief EEPROM contents, bytes the firmware uses start erased. Tests
+ * may fill them before TinyFirmwarePowerOn() to emulate saved settings.
+ */
+extern uint8_t TinyFirmwareEeprom[TINY_EEPROM_SIZE];
+
+/**
+ * \brief Run firmware initialization, does nothing when already powered.
+ */
+void TinyFirmwarePowerOn(void);
+
+/**
+ * \brief Run one main loop pass without timer tick.
+ */
+void TinyFirmwarePoll(void);
+
+/**
+ * \brief Fire 1 ms timer interrupt and run one main loop pass.
+ */
+void TinyFirmwareTick(void);
+
+/**
+ * \brief Issue control IN transfer to the firmware.
+ * \param setup SETUP packet.
+ * \param data Buffer for the data stage, wLength bytes long.
+ * \return Returns transferred bytes count.
+ */
+uint16_t TinyFirmwareControlIn(const uint8_t setup[8], uint8_t* data);
+
+/**
+ * \brief Issue control OUT transfer to the firmware, the data stage is
+ * fed to the firmware in 8 bytes chunks like V-USB does.
+ * \param setup SETUP packet.
+ * \param data Data stage, wLength bytes long.
+ * \return Returns non-zero on success, zero when the firmware stalls.
+ */
+uint8_t TinyFirmwareControlOut(const uint8_t setup[8], const uint8_t* data);
+
+/**
+ * \brief Take the report waiting for interrupt-IN endpoint.
+ * \param data Buffer, 8 bytes long.
+ * \return Returns report length, zero when nothing is waiting.
+ */
+uint8_t TinyFirmwareTakeInterrupt(uint8_t* data);
+
+/**
+ * \brief Get port B data direction, open drain outputs pull
+ * the line low when their bit is set.
+ */
+uint8_t TinyFirmwareGetPins(void);
+
+#ifdef __cplusplus
+}
+#endif
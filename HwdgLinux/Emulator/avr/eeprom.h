@@ -0,0 +1,35 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+// EEPROM is backed by an array of the emulator, the address
+// is the offset in it.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint8_t eeprom_read_byte(const uint8_t* addr);
+uint32_t eeprom_read_dword(const uint32_t* addr);
+void eeprom_write_byte(uint8_t* addr, uint8_t value);
+void eeprom_write_dword(uint32_t* addr, uint32_t value);
+void eeprom_update_byte(uint8_t* addr, uint8_t value);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+// Vectors become plain functions the emulator calls when
+// the matching event happens.
+#include <avr/io.h>
+
+#define ISR_NOBLOCK
+#define ISR(vector, ...) void vector(void)
+
+#define cli() (SREG &= (uint8_t)~0x80U)
+#define sei() (SREG |= 0x80U)
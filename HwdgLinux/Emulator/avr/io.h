@@ -0,0 +1,78 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+// Host stand-in for attiny85 registers, the emulator defines them
+// as plain variables so firmware sources build unchanged.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile uint8_t SREG;
+extern volatile uint8_t DDRB;
+extern volatile uint8_t PORTB;
+extern volatile uint8_t PINB;
+extern volatile uint8_t OSCCAL;
+extern volatile uint8_t MCUCR;
+extern volatile uint8_t GIMSK;
+extern volatile uint8_t GIFR;
+extern volatile uint8_t PCMSK;
+extern volatile uint8_t WDTCR;
+extern volatile uint8_t TIMSK;
+extern volatile uint8_t TCCR0A;
+extern volatile uint8_t TCCR0B;
+extern volatile uint8_t TCNT0;
+extern volatile uint8_t OCR0A;
+extern volatile uint8_t TCCR1;
+extern volatile uint8_t TCNT1;
+extern volatile uint8_t TIFR;
+
+#ifdef __cplusplus
+}
+#endif
+
+// As in avr/sfr_defs.h
+#define _BV(bit) (1 << (bit))
+
+// Bit numbers as in attiny85 datasheet
+#define PB0     0
+#define PB1     1
+#define PB2     2
+#define PB3     3
+#define PB4     4
+#define PB5     5
+#define ISC00   0
+#define ISC01   1
+#define PCIE    5
+#define INT0    6
+#define PCIF    5
+#define INTF0   6
+#define WDE     3
+#define WDCE    4
+#define WDIE    6
+#define OCIE0A  4
+#define WGM01   1
+#define CS02    2
+#define CS10    0
+#define CS12    2
+#define TOV1    2
+#define PORF    0
+#define EXTRF   1
+#define BORF    2
+#define WDRF    3
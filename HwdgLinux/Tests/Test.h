@@ -0,0 +1,53 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * \brief Minimal test runner, every test binary has one translation unit.
+ */
+
+inline int testFailures;
+
+#define ASSERT(condition) \
+	do { if (!(condition)) { \
+		printf("  %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+		testFailures++; return; } } while (0)
+
+struct TestCase
+{
+	const char* Name;
+	void (*Run)();
+};
+
+/**
+ * \brief Run tests and print their results.
+ * \return Returns process exit code.
+ */
+template <size_t N>
+int RunTests(const TestCase (&tests)[N])
+{
+	for (const TestCase& test : tests)
+	{
+		const int before = testFailures;
+		test.Run();
+		printf("%s %s\n", testFailures == before ? "PASS" : "FAIL", test.Name);
+	}
+	return testFailures != 0;
+}
@@ -0,0 +1,171 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include <errno.h>
+#include <stdio.h>
+#include "Test.h"
+#include "../src/TinyClient.h"
+#include "../Emulator/TinyEmulator.h"
+
+/**
+ * \brief TinyClient tests against HwdgTiny sources. Firmware state is shared
+ * by all tests, every test leaves the watchdog stopped with events disabled.
+ */
+
+static TinyEmulator emulator;
+static TinyClient client(emulator);
+
+static Response Send(uint8_t command)
+{
+	Response response = UnknownCommand;
+	if (!client.SendCommand(command, response))
+		printf("  command 0x%02X failed, errno %d\n", command, errno);
+	return response;
+}
+
+/**
+ * \brief Command result comes back in the same call.
+ */
+static void SendCommandReturnsResult()
+{
+	ASSERT(Send(0xF8) == SoftwareVersion);
+	ASSERT(Send(0xFB) == Busy);
+	ASSERT(Send(0xF9) == StartOk);
+	ASSERT(Send(0xFB) == PingOk);
+	ASSERT(Send(0xFA) == StopOk);
+	ASSERT(Send(0x20) == UnknownCommand);
+}
+
+/**
+ * \brief Tagged command result is pushed through interrupt-IN, untagged one is not.
+ */
+static void TaggedCommandPushesResult()
+{
+	const uint8_t tagged[] = {0x01, 0xF8, 0x5A, 0x00, 0x00, 0x00, 0x00, 0x00};
+	ASSERT(emulator.SendReport(tagged, sizeof(tagged)) == sizeof(tagged));
+	uint8_t report[8];
+	ASSERT(emulator.ReadReport(report, sizeof(report)) == 3);
+	ASSERT(report[0] == 0x04);
+	ASSERT(report[1] == 0x5A);
+	ASSERT(report[2] == SoftwareVersion);
+
+	const uint8_t untagged[] = {0x01, 0xF8};
+	ASSERT(emulator.SendReport(untagged, sizeof(untagged)) == sizeof(untagged));
+	ASSERT(emulator.ReadReport(report, sizeof(report)) < 0);
+}
+
+/**
+ * \brief Commands above batch size are split, results keep the order.
+ */
+static void SendCommandsSplitsBatches()
+{
+	const uint8_t commands[] = {0x40, 0x80, 0xF9, 0xFB, 0xFB, 0xFB, 0xFB, 0x40, 0xFA};
+	const Response expected[] = {
+		SetResponseTimeoutOk, SetRebootTimeoutOk, StartOk, PingOk, PingOk,
+		PingOk, PingOk, Busy, StopOk
+	};
+	Response responses[sizeof(commands)];
+	ASSERT(client.SendCommands(commands, sizeof(commands), responses));
+	for (size_t i = 0; i < sizeof(commands); i++)
+		ASSERT(responses[i] == expected[i]);
+}
+
+/**
+ * \brief Status reflects settings and running state.
+ */
+static void GetStatusDecodesStatus()
+{
+	ASSERT(Send(0x41) == SetResponseTimeoutOk);
+	ASSERT(Send(0x81) == SetRebootTimeoutOk);
+	ASSERT(Send(0xF9) == StartOk);
+
+	WatchdogStatus status;
+	const bool result = client.GetStatus(status);
+	Send(0xFA);
+	ASSERT(result);
+	ASSERT(status.State & IsRunning);
+	ASSERT(status.ResponseTimeout == 10000);
+	ASSERT(status.RebootTimeout == 15000);
+
+	ASSERT(client.GetStatus(status));
+	ASSERT(!(status.State & IsRunning));
+}
+
+/**
+ * \brief Only events are pushed through interrupt-IN, command results are not.
+ */
+static void WaitEventReturnsEvents()
+{
+	ASSERT(Send(0x02) == EnableEventsOk);
+	ASSERT(Send(0x40) == SetResponseTimeoutOk);
+	ASSERT(Send(0xF9) == StartOk);
+
+	Response event;
+	ASSERT(client.WaitEvent(event, 0) == 0);
+	emulator.Tick(5000);
+	const bool asserted = emulator.IsResetAsserted();
+	const int result = client.WaitEvent(event, 0);
+
+	Send(0xFA);
+	Send(0x03);
+	emulator.Tick(1000);
+	ASSERT(asserted);
+	ASSERT(result == 1);
+	ASSERT(event == FirstResetOccurred);
+	ASSERT(!emulator.IsResetAsserted());
+}
+
+/**
+ * \brief No events are pushed while they are disabled.
+ */
+static void EventsDisabledPushNothing()
+{
+	ASSERT(Send(0x40) == SetResponseTimeoutOk);
+	ASSERT(Send(0xF9) == StartOk);
+	emulator.Tick(5000);
+
+	Response event;
+	const int result = client.ReadEvent(event);
+	Send(0xFA);
+	emulator.Tick(1000);
+	ASSERT(result == 0);
+}
+
+/**
+ * \brief Diagnostics report is read without sending a command.
+ */
+static void GetDiagnosticsReadsCounters()
+{
+	uint8_t worstTick = 0xFF;
+	uint16_t retries = 0xFFFF;
+	ASSERT(client.GetDiagnostics(worstTick, retries));
+	ASSERT(retries == 0);
+}
+
+int main()
+{
+	const TestCase tests[] = {
+		{"SendCommandReturnsResult", SendCommandReturnsResult},
+		{"TaggedCommandPushesResult", TaggedCommandPushesResult},
+		{"SendCommandsSplitsBatches", SendCommandsSplitsBatches},
+		{"GetStatusDecodesStatus", GetStatusDecodesStatus},
+		{"WaitEventReturnsEvents", WaitEventReturnsEvents},
+		{"EventsDisabledPushNothing", EventsDisabledPushNothing},
+		{"GetDiagnosticsReadsCounters", GetDiagnosticsReadsCounters},
+	};
+	return RunTests(tests);
+}
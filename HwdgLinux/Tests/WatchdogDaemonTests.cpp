@@ -0,0 +1,262 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include <fcntl.h>
+#include <pty.h>
+#include <signal.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "Test.h"
+#include "../src/SerialLink.h"
+#include "../src/WatchdogDaemon.h"
+#include "../../Hwdg/src/Crc7Core.h"
+
+/**
+ * \brief SerialLink and WatchdogDaemon tests, HWDG is faked on a pseudo terminal.
+ */
+
+/**
+ * \brief Answers tagged commands on pty master like HWDG does.
+ */
+class FakeHwdg
+{
+public:
+	FakeHwdg() :
+		master(-1),
+		slave(-1),
+		running(false),
+		events(false),
+		silent(false),
+		pings(0)
+	{
+		char name[64];
+		openpty(&master, &slave, name, nullptr, nullptr);
+		path = name;
+		termios tty;
+		tcgetattr(slave, &tty);
+		cfmakeraw(&tty);
+		tcsetattr(slave, TCSANOW, &tty);
+		fcntl(master, F_SETFL, O_NONBLOCK);
+	}
+
+	~FakeHwdg()
+	{
+		close(master);
+		close(slave);
+	}
+
+	void Serve()
+	{
+		uint8_t data[3];
+		while (read(master, data, sizeof(data)) == sizeof(data))
+		{
+			if (silent || data[0] != SERIAL_TAG_COMMAND) continue;
+			uint8_t response[7] = {TaggedResponse, data[1]};
+			uint8_t length = 3;
+			switch (data[2])
+			{
+			case 0x01:
+				// Response 10 s, reboot 15 s
+				response[2] = 0x01;
+				response[3] = 0x04 | running;
+				response[4] = 0x00;
+				response[5] = events ? 0x02 : 0x00;
+				response[6] = Crc7(&response[2], 4);
+				length = 7;
+				break;
+			case 0x02: events = true; response[2] = EnableEventsOk; break;
+			case 0xF9: running = true; response[2] = StartOk; break;
+			case 0xFA: running = false; response[2] = StopOk; break;
+			case 0xFB: pings++; response[2] = running ? PingOk : Busy; break;
+			default: response[2] = UnknownCommand; break;
+			}
+			write(master, response, length);
+		}
+	}
+
+	void Post(uint8_t event)
+	{
+		write(master, &event, 1);
+	}
+
+	int master;
+	int slave;
+	std::string path;
+	bool running;
+	bool events;
+	bool silent;
+	int pings;
+};
+
+static DaemonSettings CreateSettings(const FakeHwdg& device)
+{
+	DaemonSettings settings;
+	settings.Port = device.path;
+	settings.PingInterval = 30;
+	settings.StatusInterval = 20;
+	settings.ResponseTimeout = 15;
+	return settings;
+}
+
+/**
+ * \brief Run daemon and fake device until condition holds or time is out.
+ */
+template <class Condition>
+static bool RunUntil(WatchdogDaemon& daemon, FakeHwdg& device, Condition condition)
+{
+	timespec start, now;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	do
+	{
+		if (condition()) return true;
+		daemon.RunOnce(2);
+		device.Serve();
+		clock_gettime(CLOCK_MONOTONIC, &now);
+	}
+	while ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 < 1000);
+	return condition();
+}
+
+/**
+ * \brief Tagged responses and both event kinds are told apart.
+ */
+static void SerialLinkSplitsFrames()
+{
+	SerialLink link;
+	uint8_t command[SERIAL_TAGGED_LENGTH];
+	link.Encode(7, 0x01, command);
+	ASSERT(command[0] == SERIAL_TAG_COMMAND && command[1] == 7 && command[2] == 0x01);
+
+	uint8_t status[] = {TaggedResponse, 7, 0x30, 0x31, 0x32, 0x33, 0};
+	status[6] = Crc7(&status[2], 4);
+	uint8_t frame[] = {0xA5, 9, SoftResetOccurred, 0};
+	frame[3] = Crc7(frame, 3);
+	const uint8_t broken[] = {0xA5, 10, HardResetOccurred, 0x00};
+	const uint8_t stream[] = {MovedToIdle, TaggedResponse, 8, PingOk};
+
+	SerialFrame result;
+	int frames = 0;
+	for (const uint8_t data : status)
+		frames += link.Feed(data, result);
+	ASSERT(frames == 1);
+	ASSERT(result.Kind == FrameResponse && result.Tag == 7 && result.Length == 5);
+	ASSERT(memcmp(result.Data, &status[2], 5) == 0);
+
+	frames = 0;
+	for (const uint8_t data : frame)
+		frames += link.Feed(data, result);
+	ASSERT(frames == 1);
+	ASSERT(result.Kind == FrameEvent && result.Tag == 9 && result.Data[0] == SoftResetOccurred);
+
+	frames = 0;
+	for (const uint8_t data : broken)
+		frames += link.Feed(data, result);
+	ASSERT(frames == 0);
+
+	ASSERT(link.Feed(stream[0], result));
+	ASSERT(result.Kind == FrameEvent && result.Data[0] == MovedToIdle);
+	ASSERT(!link.Feed(stream[1], result));
+	ASSERT(!link.Feed(stream[2], result));
+	ASSERT(link.Feed(stream[3], result));
+	ASSERT(result.Kind == FrameResponse && result.Tag == 8 && result.Data[0] == PingOk);
+}
+
+/**
+ * \brief Daemon confirms HWDG by status, starts monitoring and pings it.
+ */
+static void DaemonStartsAndPings()
+{
+	FakeHwdg device;
+	WatchdogDaemon daemon(CreateSettings(device));
+	int connected = 0;
+	daemon.OnConnected = [&connected](const WatchdogStatus&) { connected++; };
+	ASSERT(daemon.Init());
+
+	ASSERT(RunUntil(daemon, device, [&]() { return device.pings >= 2; }));
+	ASSERT(connected == 1);
+	ASSERT(daemon.IsConnected());
+	ASSERT(device.running);
+	ASSERT(device.events);
+}
+
+/**
+ * \brief Events HWDG sends between responses reach the callback.
+ */
+static void DaemonDeliversEvents()
+{
+	FakeHwdg device;
+	WatchdogDaemon daemon(CreateSettings(device));
+	Response event = UnknownCommand;
+	daemon.OnEvent = [&event](Response value) { event = value; };
+	ASSERT(daemon.Init());
+	ASSERT(RunUntil(daemon, device, [&]() { return daemon.IsConnected(); }));
+
+	device.Post(SoftResetOccurred);
+	ASSERT(RunUntil(daemon, device, [&]() { return event == SoftResetOccurred; }));
+}
+
+/**
+ * \brief Silent HWDG is dropped and picked up again once it answers.
+ */
+static void DaemonReconnects()
+{
+	FakeHwdg device;
+	WatchdogDaemon daemon(CreateSettings(device));
+	int connected = 0;
+	int disconnected = 0;
+	daemon.OnConnected = [&connected](const WatchdogStatus&) { connected++; };
+	daemon.OnDisconnected = [&disconnected]() { disconnected++; };
+	ASSERT(daemon.Init());
+	ASSERT(RunUntil(daemon, device, [&]() { return connected == 1; }));
+
+	device.silent = true;
+	ASSERT(RunUntil(daemon, device, [&]() { return disconnected == 1; }));
+	ASSERT(!daemon.IsConnected());
+
+	device.silent = false;
+	ASSERT(RunUntil(daemon, device, [&]() { return connected == 2; }));
+}
+
+/**
+ * \brief SIGTERM stops monitoring before the daemon quits.
+ */
+static void DaemonStopsOnSignal()
+{
+	FakeHwdg device;
+	WatchdogDaemon daemon(CreateSettings(device));
+	ASSERT(daemon.Init());
+	ASSERT(daemon.WatchSignals());
+	ASSERT(RunUntil(daemon, device, [&]() { return device.running; }));
+
+	raise(SIGTERM);
+	ASSERT(RunUntil(daemon, device, [&]() { return daemon.IsQuitting(); }));
+	ASSERT(!device.running);
+}
+
+int main()
+{
+	const TestCase tests[] = {
+		{"SerialLinkSplitsFrames", SerialLinkSplitsFrames},
+		{"DaemonStartsAndPings", DaemonStartsAndPings},
+		{"DaemonDeliversEvents", DaemonDeliversEvents},
+		{"DaemonReconnects", DaemonReconnects},
+		{"DaemonStopsOnSignal", DaemonStopsOnSignal},
+	};
+	return RunTests(tests);
+}
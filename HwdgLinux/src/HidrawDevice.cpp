@@ -0,0 +1,109 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "HidrawDevice.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fstream>
+#include <linux/hidraw.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// hidraw class directory
+#define SYSFS_HIDRAW "/sys/class/hidraw"
+
+HidrawDevice::HidrawDevice() :
+	fd(-1)
+{
+}
+
+HidrawDevice::~HidrawDevice()
+{
+	Close();
+}
+
+std::vector<std::string> HidrawDevice::Enumerate(uint16_t vendorId, uint16_t productId,
+                                                 const std::string& name)
+{
+	std::vector<std::string> result;
+	DIR* dir = opendir(SYSFS_HIDRAW);
+	if (dir == nullptr) return result;
+
+	// uevent of the HID device carries HID_ID=bus:vendor:product and HID_NAME
+	char expected[32];
+	snprintf(expected, sizeof(expected), "HID_ID=0003:%08X:%08X", vendorId, productId);
+
+	while (const dirent* entry = readdir(dir))
+	{
+		if (entry->d_name[0] == '.') continue;
+
+		std::ifstream uevent(std::string(SYSFS_HIDRAW "/") + entry->d_name + "/device/uevent");
+		bool idMatch = false;
+		bool nameMatch = name.empty();
+		std::string line;
+		while (std::getline(uevent, line))
+		{
+			if (line == expected)
+				idMatch = true;
+			else if (line.compare(0, 9, "HID_NAME=") == 0 && line.size() >= 9 + name.size())
+				nameMatch = nameMatch || line.compare(line.size() - name.size(), name.size(), name) == 0;
+		}
+		if (idMatch && nameMatch)
+			result.push_back(std::string("/dev/") + entry->d_name);
+	}
+	closedir(dir);
+	return result;
+}
+
+bool HidrawDevice::Open(const std::string& path)
+{
+	Close();
+	fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	return fd >= 0;
+}
+
+void HidrawDevice::Close()
+{
+	if (fd < 0) return;
+	close(fd);
+	fd = -1;
+}
+
+int HidrawDevice::SendReport(const uint8_t* report, size_t length)
+{
+	// Device has no interrupt-OUT endpoint, hidraw turns the write
+	// into SET_REPORT and returns when the control transfer is done
+	return write(fd, report, length);
+}
+
+int HidrawDevice::GetReport(uint8_t* report, size_t length)
+{
+	// Firmware answers any report type, feature request is the one
+	// every hidraw kernel supports
+	return ioctl(fd, HIDIOCGFEATURE(length), report);
+}
+
+int HidrawDevice::ReadReport(uint8_t* report, size_t length)
+{
+	return read(fd, report, length);
+}
+
+int HidrawDevice::GetFd() const
+{
+	return fd;
+}
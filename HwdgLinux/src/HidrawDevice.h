@@ -0,0 +1,64 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <string>
+#include <vector>
+#include "IHidTransport.h"
+
+/**
+ * \brief Linux hidraw transport. Output reports go with one write(), feature
+ * reports with one ioctl(), interrupt-IN reports are read without blocking.
+ */
+class HidrawDevice : public IHidTransport
+{
+public:
+	HidrawDevice();
+	~HidrawDevice();
+	HidrawDevice(const HidrawDevice&) = delete;
+	HidrawDevice& operator=(const HidrawDevice&) = delete;
+
+	/**
+	 * \brief Find hidraw nodes through sysfs without opening them.
+	 * \param vendorId USB vendor ID.
+	 * \param productId USB product ID.
+	 * \param name Expected HID name, shared VID/PID pairs tell devices
+	 * apart by it, empty string matches any name.
+	 * \return Returns device node paths, e.g. /dev/hidraw0.
+	 */
+	static std::vector<std::string> Enumerate(uint16_t vendorId, uint16_t productId,
+	                                          const std::string& name);
+
+	/**
+	 * \brief Open device node in non-blocking mode.
+	 * \param path Device node path.
+	 * \return Returns true on success, otherwise errno tells the reason.
+	 */
+	bool Open(const std::string& path);
+
+	/**
+	 * \brief Close device node, does nothing if it is not open.
+	 */
+	void Close();
+
+	int SendReport(const uint8_t* report, size_t length) override;
+	int GetReport(uint8_t* report, size_t length) override;
+	int ReadReport(uint8_t* report, size_t length) override;
+	int GetFd() const override;
+private:
+	int fd;
+};
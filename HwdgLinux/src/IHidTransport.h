@@ -0,0 +1,60 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * \brief HID report transport. Buffers start with the report ID, calls return
+ * transferred bytes count or -1 and leave the reason in errno.
+ */
+class IHidTransport
+{
+public:
+	virtual ~IHidTransport()
+	{
+	}
+
+	/**
+	 * \brief Send output report with SET_REPORT, returns once the device has it.
+	 * \param report Report ID followed by report data.
+	 * \param length Report length including ID.
+	 */
+	virtual int SendReport(const uint8_t* report, size_t length) = 0;
+
+	/**
+	 * \brief Read report with GET_REPORT.
+	 * \param report Buffer with report ID in the first byte.
+	 * \param length Buffer length.
+	 */
+	virtual int GetReport(uint8_t* report, size_t length) = 0;
+
+	/**
+	 * \brief Take report the device pushed through interrupt-IN endpoint,
+	 * never blocks and fails with EAGAIN when there is none.
+	 * \param report Buffer for the report.
+	 * \param length Buffer length.
+	 */
+	virtual int ReadReport(uint8_t* report, size_t length) = 0;
+
+	/**
+	 * \brief Get descriptor that becomes readable when ReadReport()
+	 * has a report, for poll() or epoll.
+	 */
+	virtual int GetFd() const = 0;
+};
@@ -0,0 +1,111 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "SerialLink.h"
+#include "../../Hwdg/src/Crc7Core.h"
+#include "../../Hwdg/src/EventChannel.h"
+#include "../../Hwdg/src/WatchdogCore.h"
+
+// Waiting for TaggedResponse, event or event frame marker
+#define STATE_IDLE             ((uint8_t)0x00U)
+// Waiting for response tag
+#define STATE_TAG              ((uint8_t)0x01U)
+// Receiving response bytes
+#define STATE_RESPONSE         ((uint8_t)0x02U)
+// Receiving event frame
+#define STATE_EVENT            ((uint8_t)0x03U)
+
+SerialLink::SerialLink() :
+	state(STATE_IDLE),
+	received(0),
+	current(),
+	lengths()
+{
+}
+
+void SerialLink::Encode(const uint8_t tag, const uint8_t command, uint8_t* buffer)
+{
+	lengths[tag] = command == WDG_GET_STATUS ? SERIAL_RESPONSE_MAX : 1;
+	buffer[0] = SERIAL_TAG_COMMAND;
+	buffer[1] = tag;
+	buffer[2] = command;
+}
+
+bool SerialLink::Feed(const uint8_t data, SerialFrame& frame)
+{
+	switch (state)
+	{
+	case STATE_IDLE:
+		if (data == TaggedResponse)
+		{
+			state = STATE_TAG;
+		}
+		else if (data == EVENT_MARKER)
+		{
+			current.Data[0] = data;
+			received = 1;
+			state = STATE_EVENT;
+		}
+		else if (data >= FirstResetOccurred && data <= WatchdogOk)
+		{
+			frame.Kind = FrameEvent;
+			frame.Tag = 0;
+			frame.Length = 1;
+			frame.Data[0] = data;
+			return true;
+		}
+		return false;
+
+	case STATE_TAG:
+		current.Kind = FrameResponse;
+		current.Tag = data;
+		// Tag we did not send, most likely a single byte response
+		current.Length = lengths[data] ? lengths[data] : 1;
+		received = 0;
+		state = STATE_RESPONSE;
+		return false;
+
+	case STATE_RESPONSE:
+		current.Data[received++] = data;
+		if (received < current.Length) return false;
+		state = STATE_IDLE;
+		frame = current;
+		return true;
+
+	default:
+		// Frame is collected whole to check its CRC, the
+		// event code is moved to the first byte afterwards
+		if (received < EVENT_FRAME_SIZE - 1)
+		{
+			current.Data[received++] = data;
+			return false;
+		}
+		state = STATE_IDLE;
+		if (Crc7(current.Data, EVENT_FRAME_SIZE - 1) != data) return false;
+		frame.Kind = FrameEvent;
+		frame.Tag = current.Data[1];
+		frame.Length = 1;
+		frame.Data[0] = current.Data[2];
+		return true;
+	}
+}
+
+void SerialLink::Reset()
+{
+	state = STATE_IDLE;
+	received = 0;
+}
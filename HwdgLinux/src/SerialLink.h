@@ -0,0 +1,86 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <stdint.h>
+
+// TagNextCommand command, the tag follows it
+#define SERIAL_TAG_COMMAND     ((uint8_t)0x0DU)
+// Tagged command length: TagNextCommand, tag and command
+#define SERIAL_TAGGED_LENGTH   ((uint8_t)3U)
+// Longest response: status bytes and checksum
+#define SERIAL_RESPONSE_MAX    ((uint8_t)5U)
+
+/**
+ * \brief Received frame kinds.
+ */
+enum SerialFrameKind
+{
+	FrameResponse,
+	FrameEvent,
+};
+
+/**
+ * \brief Tagged command response or event.
+ */
+struct SerialFrame
+{
+	SerialFrameKind Kind;
+	// Tag of the command, event sequence number in stream mode
+	uint8_t Tag;
+	uint8_t Length;
+	// Response bytes, event code for events
+	uint8_t Data[SERIAL_RESPONSE_MAX];
+};
+
+/**
+ * \brief Splits the byte stream of HWDG serial protocol into tagged responses
+ * and events, both legacy single byte ones and stream frames.
+ * \remarks Responses of untagged commands can't be told from events and
+ * are dropped, every command is sent tagged.
+ */
+class SerialLink
+{
+public:
+	SerialLink();
+
+	/**
+	 * \brief Build tagged command and remember its response length.
+	 * \param tag Tag the response comes with.
+	 * \param command Command without arguments.
+	 * \param buffer Output, SERIAL_TAGGED_LENGTH bytes.
+	 */
+	void Encode(uint8_t tag, uint8_t command, uint8_t* buffer);
+
+	/**
+	 * \brief Feed received byte.
+	 * \param data Received byte.
+	 * \param frame Completed frame.
+	 * \return Returns true when frame is completed by this byte.
+	 */
+	bool Feed(uint8_t data, SerialFrame& frame);
+
+	/**
+	 * \brief Drop partially received frame, e.g. after reconnection.
+	 */
+	void Reset();
+private:
+	uint8_t state;
+	uint8_t received;
+	SerialFrame current;
+	uint8_t lengths[256];
+};
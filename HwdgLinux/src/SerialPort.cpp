@@ -0,0 +1,112 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "SerialPort.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+SerialPort::SerialPort() :
+	fd(-1)
+{
+}
+
+SerialPort::~SerialPort()
+{
+	Close();
+}
+
+static speed_t GetSpeed(const uint32_t baudrate)
+{
+	switch (baudrate)
+	{
+	case 9600: return B9600;
+	case 19200: return B19200;
+	case 38400: return B38400;
+	case 57600: return B57600;
+	case 115200: return B115200;
+	default: return B0;
+	}
+}
+
+bool SerialPort::Open(const std::string& path, const uint32_t baudrate)
+{
+	Close();
+	const speed_t speed = GetSpeed(baudrate);
+	if (speed == B0)
+	{
+		errno = EINVAL;
+		return false;
+	}
+
+	fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0) return false;
+
+	termios tty;
+	if (tcgetattr(fd, &tty) != 0)
+	{
+		Close();
+		return false;
+	}
+	cfmakeraw(&tty);
+	cfsetispeed(&tty, speed);
+	cfsetospeed(&tty, speed);
+	tty.c_cflag |= CLOCAL | CREAD;
+	tty.c_cflag &= ~(CSTOPB | CRTSCTS | HUPCL);
+	tty.c_iflag &= ~(IXON | IXOFF | IXANY);
+	// Non-blocking read fails with EAGAIN when there is no data
+	// only if it would block otherwise, zero is left for hang up
+	tty.c_cc[VMIN] = 1;
+	tty.c_cc[VTIME] = 0;
+	if (tcsetattr(fd, TCSANOW, &tty) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	// Bytes received before the port was configured are garbage
+	tcflush(fd, TCIOFLUSH);
+	return true;
+}
+
+void SerialPort::Close()
+{
+	if (fd < 0) return;
+	close(fd);
+	fd = -1;
+}
+
+bool SerialPort::IsOpen() const
+{
+	return fd >= 0;
+}
+
+int SerialPort::Write(const uint8_t* data, const size_t length)
+{
+	return write(fd, data, length);
+}
+
+int SerialPort::Read(uint8_t* data, const size_t length)
+{
+	return read(fd, data, length);
+}
+
+int SerialPort::GetFd() const
+{
+	return fd;
+}
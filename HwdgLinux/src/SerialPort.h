@@ -0,0 +1,73 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/**
+ * \brief Serial port kept open in raw non-blocking mode, so a command costs
+ * one write() and its response one read() once the port is configured.
+ */
+class SerialPort
+{
+public:
+	SerialPort();
+	~SerialPort();
+	SerialPort(const SerialPort&) = delete;
+	SerialPort& operator=(const SerialPort&) = delete;
+
+	/**
+	 * \brief Open and configure port: raw 8N1, no flow control. Modem lines
+	 * are left as they are on close, so the board is not reset by reopening.
+	 * \param path Device node path, e.g. /dev/ttyUSB0.
+	 * \param baudrate Baud rate, one of termios supported ones.
+	 * \return Returns true on success, otherwise errno tells the reason.
+	 */
+	bool Open(const std::string& path, uint32_t baudrate);
+
+	/**
+	 * \brief Close port, does nothing if it is not open.
+	 */
+	void Close();
+
+	/**
+	 * \brief Determine if port is open.
+	 */
+	bool IsOpen() const;
+
+	/**
+	 * \brief Write data without blocking.
+	 * \return Returns written bytes count or -1.
+	 */
+	int Write(const uint8_t* data, size_t length);
+
+	/**
+	 * \brief Read available data without blocking.
+	 * \return Returns read bytes count, 0 on hang up or -1, EAGAIN when
+	 * there is nothing to read.
+	 */
+	int Read(uint8_t* data, size_t length);
+
+	/**
+	 * \brief Get port descriptor for epoll.
+	 */
+	int GetFd() const;
+private:
+	int fd;
+};
@@ -0,0 +1,187 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "TinyClient.h"
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include "../../Hwdg/src/Crc7Core.h"
+
+// Single command report ID
+#define REPORT_COMMAND         ((uint8_t)1U)
+// Command batch report ID
+#define REPORT_BATCH           ((uint8_t)2U)
+// Diagnostics report ID
+#define REPORT_DIAGNOSTICS     ((uint8_t)3U)
+// Status report length: status bytes, checksum and command result
+#define STATUS_LENGTH          ((uint8_t)6U)
+// Checksum index in status report
+#define STATUS_CRC             STATUS_SIZE
+// Command result index in status and event reports
+#define STATUS_RESPONSE        ((uint8_t)5U)
+// Batch report length: report ID and results
+#define BATCH_LENGTH           ((uint8_t)(TINY_BATCH_SIZE + 1U))
+// Diagnostics report length: report ID, worst tick and retries
+#define DIAGNOSTICS_LENGTH     ((uint8_t)4U)
+// Longest interrupt-IN report
+#define REPORT_MAX_LENGTH      ((uint8_t)8U)
+
+TinyClient::TinyClient(IHidTransport& transport) :
+	transport(transport)
+{
+}
+
+bool TinyClient::Transact(const uint8_t command, uint8_t* report)
+{
+	// Firmware runs the command while SET_REPORT data arrives, the
+	// result is ready for GET_REPORT once the write returns
+	const uint8_t request[] = {REPORT_COMMAND, command};
+	if (transport.SendReport(request, sizeof(request)) < 0)
+		return false;
+
+	report[0] = REPORT_COMMAND;
+	const int length = transport.GetReport(report, STATUS_LENGTH);
+	if (length < 0)
+		return false;
+	if (length < STATUS_LENGTH)
+	{
+		errno = EPROTO;
+		return false;
+	}
+	return true;
+}
+
+bool TinyClient::SendCommand(const uint8_t command, Response& response)
+{
+	uint8_t report[STATUS_LENGTH];
+	if (!Transact(command, report))
+		return false;
+	response = (Response)report[STATUS_RESPONSE];
+	return true;
+}
+
+bool TinyClient::SendCommands(const uint8_t* commands, size_t count, Response* responses)
+{
+	while (count > 0)
+	{
+		const size_t size = count < TINY_BATCH_SIZE ? count : TINY_BATCH_SIZE;
+		uint8_t report[BATCH_LENGTH] = {REPORT_BATCH};
+		memcpy(&report[1], commands, size);
+		if (transport.SendReport(report, size + 1) < 0)
+			return false;
+
+		report[0] = REPORT_BATCH;
+		const int length = transport.GetReport(report, sizeof(report));
+		if (length < 0)
+			return false;
+		if ((size_t)length < size + 1)
+		{
+			errno = EPROTO;
+			return false;
+		}
+		for (size_t i = 0; i < size; i++)
+			responses[i] = (Response)report[i + 1];
+
+		commands += size;
+		responses += size;
+		count -= size;
+	}
+	return true;
+}
+
+bool TinyClient::GetStatus(WatchdogStatus& status)
+{
+	uint8_t report[STATUS_LENGTH];
+	if (!Transact(0x01, report))
+		return false;
+	if (Crc7(report, STATUS_CRC) != report[STATUS_CRC])
+	{
+		errno = EBADMSG;
+		return false;
+	}
+	status = DecodeStatus(report);
+	return true;
+}
+
+bool TinyClient::GetDiagnostics(uint8_t& worstTick, uint16_t& retries)
+{
+	uint8_t report[DIAGNOSTICS_LENGTH] = {REPORT_DIAGNOSTICS};
+	const int length = transport.GetReport(report, sizeof(report));
+	if (length < 0)
+		return false;
+	if (length < DIAGNOSTICS_LENGTH)
+	{
+		errno = EPROTO;
+		return false;
+	}
+	worstTick = report[1];
+	retries = report[2] | report[3] << 8;
+	return true;
+}
+
+int TinyClient::ReadEvent(Response& event)
+{
+	uint8_t report[REPORT_MAX_LENGTH];
+	for (;;)
+	{
+		const int length = transport.ReadReport(report, sizeof(report));
+		if (length < 0)
+			return errno == EAGAIN ? 0 : -1;
+
+		// Only events are pushed, anything else is skipped
+		if (report[0] != REPORT_COMMAND || length <= STATUS_RESPONSE) continue;
+		const uint8_t code = report[STATUS_RESPONSE];
+		if (code < FirstResetOccurred || code > WatchdogOk) continue;
+
+		event = (Response)code;
+		return 1;
+	}
+}
+
+int TinyClient::WaitEvent(Response& event, const int timeout)
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	const int64_t deadline = now.tv_sec * 1000LL + now.tv_nsec / 1000000 + timeout;
+
+	for (;;)
+	{
+		const int result = ReadEvent(event);
+		if (result != 0)
+			return result;
+
+		// Command results wake us up as well, wait only for the time left
+		int left = timeout;
+		if (timeout >= 0)
+		{
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			const int64_t remaining = deadline - (now.tv_sec * 1000LL + now.tv_nsec / 1000000);
+			left = remaining > 0 ? (int)remaining : 0;
+		}
+
+		pollfd fd = {transport.GetFd(), POLLIN, 0};
+		const int ready = poll(&fd, 1, left);
+		if (ready <= 0)
+			return ready;
+		if (fd.revents & (POLLERR | POLLHUP))
+		{
+			errno = ENODEV;
+			return -1;
+		}
+	}
+}
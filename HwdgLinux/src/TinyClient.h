@@ -0,0 +1,97 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include "IHidTransport.h"
+#include "WatchdogStatus.h"
+#include "../../Hwdg/src/Response.h"
+
+// HWDG Tiny USB vendor ID, V-USB shared one
+#define TINY_VENDOR_ID         ((uint16_t)0x16C0U)
+// HWDG Tiny USB product ID, V-USB shared HID one
+#define TINY_PRODUCT_ID        ((uint16_t)0x05DFU)
+// HID name, tells HWDG Tiny apart from other devices on shared IDs
+#define TINY_NAME              "HWDG Tiny"
+// Commands one batch report carries
+#define TINY_BATCH_SIZE        ((uint8_t)7U)
+
+/**
+ * \brief HWDG Tiny client. A command takes two control transfers: SET_REPORT
+ * with the command and GET_REPORT with its result, so it never waits for
+ * interrupt-IN polling. Interrupt-IN reports only deliver events.
+ */
+class TinyClient
+{
+public:
+	/**
+	 * \brief Create client on top of opened transport.
+	 * \param transport Transport the device is reached through.
+	 */
+	explicit TinyClient(IHidTransport& transport);
+
+	/**
+	 * \brief Send command and read its result.
+	 * \param command Command to be sent.
+	 * \param response Command result.
+	 * \return Returns false on I/O error, errno tells the reason.
+	 */
+	bool SendCommand(uint8_t command, Response& response);
+
+	/**
+	 * \brief Send several commands, up to TINY_BATCH_SIZE of them per transfer.
+	 * Zero byte is batch padding, ChipReset cannot be batched.
+	 * \param commands Commands to be sent.
+	 * \param count Commands count.
+	 * \param responses Results in the same order as commands.
+	 * \return Returns false on I/O error, errno tells the reason.
+	 */
+	bool SendCommands(const uint8_t* commands, size_t count, Response* responses);
+
+	/**
+	 * \brief Get actual HWDG status.
+	 * \param status Decoded status.
+	 * \return Returns false on I/O error or checksum mismatch.
+	 */
+	bool GetStatus(WatchdogStatus& status);
+
+	/**
+	 * \brief Get firmware diagnostics.
+	 * \param worstTick Longest timer tick processing, us.
+	 * \param retries Control transfers the host had to retry.
+	 * \return Returns false on I/O error, errno tells the reason.
+	 */
+	bool GetDiagnostics(uint8_t& worstTick, uint16_t& retries);
+
+	/**
+	 * \brief Take pushed event without blocking, command results the
+	 * device also pushes are dropped on the way.
+	 * \param event Received event.
+	 * \return Returns 1 when event received, 0 when there is none, -1 on error.
+	 */
+	int ReadEvent(Response& event);
+
+	/**
+	 * \brief Wait for pushed event.
+	 * \param event Received event.
+	 * \param timeout Timeout in milliseconds, -1 waits forever.
+	 * \return Returns 1 when event received, 0 on timeout, -1 on error.
+	 */
+	int WaitEvent(Response& event, int timeout);
+private:
+	bool Transact(uint8_t command, uint8_t* report);
+	IHidTransport& transport;
+};
@@ -0,0 +1,433 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "WatchdogDaemon.h"
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include "../../Hwdg/src/Crc7Core.h"
+#include "../../Hwdg/src/WatchdogCore.h"
+
+// Port is closed, reopened on status timer
+#define STATE_DISCONNECTED     ((uint8_t)0x00U)
+// Port is open, waiting for the first valid status
+#define STATE_CONNECTING       ((uint8_t)0x01U)
+// HWDG answered status request
+#define STATE_CONNECTED        ((uint8_t)0x02U)
+// Commands the daemon sends
+#define CMD_ENABLE_EVENTS      ((uint8_t)0x02U)
+#define CMD_START              ((uint8_t)0xF9U)
+#define CMD_STOP               ((uint8_t)0xFAU)
+#define CMD_PING               ((uint8_t)0xFBU)
+// Bytes taken from the port per read() call
+#define READ_CHUNK             64
+// Descriptors handled per epoll_wait() call
+#define MAX_EVENTS             8
+
+/**
+ * \brief Get monotonic time in milliseconds, never zero.
+ */
+static uint64_t Now()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000ULL + now.tv_nsec / 1000000 + 1;
+}
+
+/**
+ * \brief Arm timer descriptor.
+ * \param fd Timer descriptor.
+ * \param delay First expiration in milliseconds, zero disarms the timer.
+ * \param interval Period in milliseconds, zero makes timer one-shot.
+ */
+static void ArmTimer(const int fd, const uint64_t delay, const uint64_t interval)
+{
+	itimerspec spec = {};
+	spec.it_value.tv_sec = delay / 1000;
+	spec.it_value.tv_nsec = delay % 1000 * 1000000;
+	spec.it_interval.tv_sec = interval / 1000;
+	spec.it_interval.tv_nsec = interval % 1000 * 1000000;
+	timerfd_settime(fd, 0, &spec, nullptr);
+}
+
+/**
+ * \brief Take timer expirations so the descriptor stops being readable.
+ */
+static void DrainTimer(const int fd)
+{
+	uint64_t expirations;
+	(void)read(fd, &expirations, sizeof(expirations));
+}
+
+WatchdogDaemon::WatchdogDaemon(const DaemonSettings& settings) :
+	settings(settings),
+	epoll(-1),
+	pingTimer(-1),
+	statusTimer(-1),
+	deadlineTimer(-1),
+	signals(-1),
+	state(STATE_DISCONNECTED),
+	nextTag(0),
+	missed(0),
+	deadlineArmed(false),
+	quit(false),
+	stopping(false),
+	lastError(0),
+	lastStatus(0),
+	commands(),
+	sentAt()
+{
+}
+
+WatchdogDaemon::~WatchdogDaemon()
+{
+	port.Close();
+	for (const int fd : {epoll, pingTimer, statusTimer, deadlineTimer, signals})
+		if (fd >= 0) close(fd);
+}
+
+bool WatchdogDaemon::Init()
+{
+	epoll = epoll_create1(EPOLL_CLOEXEC);
+	pingTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	statusTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	deadlineTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (epoll < 0 || pingTimer < 0 || statusTimer < 0 || deadlineTimer < 0)
+		return false;
+
+	for (const int fd : {pingTimer, statusTimer, deadlineTimer})
+	{
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+			return false;
+	}
+
+	ArmTimer(pingTimer, settings.PingInterval, settings.PingInterval);
+	ArmTimer(statusTimer, settings.StatusInterval, settings.StatusInterval);
+	Connect();
+	return true;
+}
+
+bool WatchdogDaemon::WatchSignals()
+{
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGTERM);
+	if (sigprocmask(SIG_BLOCK, &mask, nullptr) != 0)
+		return false;
+
+	signals = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (signals < 0)
+		return false;
+
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = signals;
+	return epoll_ctl(epoll, EPOLL_CTL_ADD, signals, &event) == 0;
+}
+
+int WatchdogDaemon::Run()
+{
+	while (!quit)
+	{
+		if (!RunOnce(-1))
+			return 1;
+	}
+	return 0;
+}
+
+bool WatchdogDaemon::RunOnce(const int timeout)
+{
+	epoll_event events[MAX_EVENTS];
+	const int count = epoll_wait(epoll, events, MAX_EVENTS, timeout);
+	if (count < 0)
+		return errno == EINTR;
+
+	for (int i = 0; i < count; i++)
+	{
+		const int fd = events[i].data.fd;
+		if (fd == pingTimer)
+			OnPingTimer();
+		else if (fd == statusTimer)
+			OnStatusTimer();
+		else if (fd == deadlineTimer)
+			OnDeadlineTimer();
+		else if (fd == signals)
+			OnSignal();
+		else if (fd == port.GetFd())
+			OnSerial(events[i].events);
+	}
+	return true;
+}
+
+void WatchdogDaemon::Quit()
+{
+	quit = true;
+}
+
+bool WatchdogDaemon::IsConnected() const
+{
+	return state == STATE_CONNECTED;
+}
+
+bool WatchdogDaemon::IsQuitting() const
+{
+	return quit;
+}
+
+void WatchdogDaemon::Connect()
+{
+	if (!port.Open(settings.Port, settings.Baudrate))
+	{
+		ReportError("open");
+		return;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN | EPOLLRDHUP;
+	event.data.fd = port.GetFd();
+	if (epoll_ctl(epoll, EPOLL_CTL_ADD, port.GetFd(), &event) != 0)
+	{
+		ReportError("epoll");
+		port.Close();
+		return;
+	}
+
+	// HWDG is confirmed by a valid status, a board that resets
+	// on port open answers once it boots
+	lastError = 0;
+	state = STATE_CONNECTING;
+	link.Reset();
+	Send(WDG_GET_STATUS);
+}
+
+void WatchdogDaemon::Disconnect()
+{
+	if (!port.IsOpen()) return;
+	epoll_ctl(epoll, EPOLL_CTL_DEL, port.GetFd(), nullptr);
+	port.Close();
+
+	memset(sentAt, 0, sizeof(sentAt));
+	ArmTimer(deadlineTimer, 0, 0);
+	deadlineArmed = false;
+	missed = 0;
+
+	const bool wasConnected = state == STATE_CONNECTED;
+	state = STATE_DISCONNECTED;
+	if (stopping)
+		quit = true;
+	if (wasConnected && OnDisconnected)
+		OnDisconnected();
+}
+
+bool WatchdogDaemon::Send(const uint8_t command)
+{
+	if (!port.IsOpen()) return false;
+
+	const uint8_t tag = nextTag++;
+	uint8_t buffer[SERIAL_TAGGED_LENGTH];
+	link.Encode(tag, command, buffer);
+	// Full transmit buffer is the same as a lost command,
+	// its deadline tells about it. A part of the command that got out
+	// would make HWDG take the next byte as command, so link restarts.
+	const int written = port.Write(buffer, sizeof(buffer));
+	if (written < 0 ? errno != EAGAIN : written < (int)sizeof(buffer))
+	{
+		if (written >= 0) errno = EIO;
+		ReportError("write");
+		Disconnect();
+		return false;
+	}
+
+	commands[tag] = command;
+	sentAt[tag] = Now();
+	if (!deadlineArmed)
+		ArmDeadline();
+	return true;
+}
+
+void WatchdogDaemon::ArmDeadline()
+{
+	uint64_t oldest = 0;
+	for (const uint64_t time : sentAt)
+	{
+		if (time != 0 && (oldest == 0 || time < oldest))
+			oldest = time;
+	}
+	deadlineArmed = oldest != 0;
+	if (!deadlineArmed) return;
+
+	const uint64_t now = Now();
+	const uint64_t deadline = oldest + settings.ResponseTimeout;
+	ArmTimer(deadlineTimer, deadline > now ? deadline - now : 1, 0);
+}
+
+void WatchdogDaemon::OnSerial(const uint32_t events)
+{
+	if (events & EPOLLIN)
+	{
+		uint8_t buffer[READ_CHUNK];
+		int length;
+		while ((length = port.Read(buffer, sizeof(buffer))) > 0)
+		{
+			SerialFrame frame;
+			for (int i = 0; i < length; i++)
+			{
+				if (link.Feed(buffer[i], frame))
+					OnFrame(frame);
+			}
+			// Command sent from a frame handler may have failed
+			if (!port.IsOpen()) return;
+		}
+		if (length == 0 || errno != EAGAIN)
+		{
+			ReportError("read");
+			Disconnect();
+			return;
+		}
+	}
+	if (events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR))
+	{
+		ReportError("hang up");
+		Disconnect();
+	}
+}
+
+void WatchdogDaemon::OnFrame(const SerialFrame& frame)
+{
+	if (frame.Kind == FrameEvent)
+	{
+		if (OnEvent)
+			OnEvent((Response)frame.Data[0]);
+		return;
+	}
+
+	// Late response of a command that already timed out
+	if (sentAt[frame.Tag] == 0) return;
+	sentAt[frame.Tag] = 0;
+	missed = 0;
+
+	const uint8_t command = commands[frame.Tag];
+	if (command == WDG_GET_STATUS && Crc7(frame.Data, STATUS_SIZE) == frame.Data[STATUS_SIZE])
+		OnStatus(DecodeStatus(frame.Data));
+	else if (command == CMD_STOP && stopping)
+		quit = true;
+}
+
+void WatchdogDaemon::OnStatus(const WatchdogStatus& status)
+{
+	const bool connected = state == STATE_CONNECTING;
+	const bool updated = status.RawData != lastStatus;
+	state = STATE_CONNECTED;
+	lastStatus = status.RawData;
+
+	if (connected)
+	{
+		if (OnConnected)
+			OnConnected(status);
+		if (settings.EnableEvents && !(status.State & EventsEnabled))
+			Send(CMD_ENABLE_EVENTS);
+	}
+	else if (updated && OnUpdated)
+	{
+		OnUpdated(status);
+	}
+
+	// Idle HWDG, it was just powered or gave up resetting the host
+	// that is alive again, since the daemon is running
+	if (settings.StartMonitoring && !stopping && !(status.State & (IsRunning | WaitingForReboot)))
+		Send(CMD_START);
+}
+
+void WatchdogDaemon::OnPingTimer()
+{
+	DrainTimer(pingTimer);
+	if (state == STATE_CONNECTED && settings.StartMonitoring && !stopping)
+		Send(CMD_PING);
+}
+
+void WatchdogDaemon::OnStatusTimer()
+{
+	DrainTimer(statusTimer);
+	if (state == STATE_DISCONNECTED)
+		Connect();
+	else
+		Send(WDG_GET_STATUS);
+}
+
+void WatchdogDaemon::OnDeadlineTimer()
+{
+	DrainTimer(deadlineTimer);
+	const uint64_t now = Now();
+	for (uint64_t& time : sentAt)
+	{
+		if (time == 0 || now - time < settings.ResponseTimeout) continue;
+		time = 0;
+		if (missed < UINT8_MAX)
+			missed++;
+	}
+
+	if (stopping)
+	{
+		quit = true;
+		return;
+	}
+
+	// Board that is still booting gets unlimited time, reopening
+	// the port would only reset it once again
+	if (state == STATE_CONNECTED && missed >= settings.MaxMissed)
+	{
+		errno = ETIMEDOUT;
+		ReportError("response");
+		Disconnect();
+		return;
+	}
+	ArmDeadline();
+}
+
+void WatchdogDaemon::OnSignal()
+{
+	signalfd_siginfo info;
+	(void)read(signals, &info, sizeof(info));
+
+	if (stopping || !settings.StopOnExit || state != STATE_CONNECTED)
+	{
+		quit = true;
+		return;
+	}
+	// Quit once Stop is answered or its deadline passes
+	stopping = true;
+	Send(CMD_STOP);
+}
+
+void WatchdogDaemon::ReportError(const char* what)
+{
+	// Reconnection attempts repeat the same error, report it once
+	const int error = errno;
+	if (error == lastError) return;
+	lastError = error;
+	if (OnError)
+		OnError(what, error);
+}
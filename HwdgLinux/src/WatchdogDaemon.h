@@ -0,0 +1,139 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <functional>
+#include <string>
+#include "SerialLink.h"
+#include "SerialPort.h"
+#include "WatchdogStatus.h"
+#include "../../Hwdg/src/Response.h"
+
+/**
+ * \brief Daemon settings, intervals and timeouts are in milliseconds.
+ */
+struct DaemonSettings
+{
+	std::string Port;
+	uint32_t Baudrate = 9600;
+	// Ping period, has to be well below HWDG response timeout
+	uint32_t PingInterval = 4000;
+	// Status poll period, also the reconnection attempt period
+	uint32_t StatusInterval = 1000;
+	// Time HWDG has to answer a command
+	uint32_t ResponseTimeout = 200;
+	// Unanswered commands in a row the connection is dropped after
+	uint8_t MaxMissed = 3;
+	// Start monitoring on connection and whenever HWDG turns out idle
+	bool StartMonitoring = true;
+	// Enable events on connection
+	bool EnableEvents = true;
+	// Stop monitoring when the daemon exits on a signal
+	bool StopOnExit = true;
+};
+
+/**
+ * \brief Serial HWDG daemon. Keeps the port open and configured, pings, status
+ * polls and events share it through one epoll loop on one thread, the port is
+ * reopened when HWDG disconnects or stops answering.
+ * \remarks Callbacks run on the daemon thread.
+ */
+class WatchdogDaemon
+{
+public:
+	explicit WatchdogDaemon(const DaemonSettings& settings);
+	~WatchdogDaemon();
+	WatchdogDaemon(const WatchdogDaemon&) = delete;
+	WatchdogDaemon& operator=(const WatchdogDaemon&) = delete;
+
+	/**
+	 * \brief Create epoll and timers and try to connect.
+	 * \return Returns false on failure, errno tells the reason.
+	 */
+	bool Init();
+
+	/**
+	 * \brief Handle SIGINT and SIGTERM in the loop, blocks them for the thread.
+	 * \return Returns false on failure, errno tells the reason.
+	 */
+	bool WatchSignals();
+
+	/**
+	 * \brief Run the loop until Quit() or a signal.
+	 * \return Returns 0 on normal exit, 1 on epoll failure.
+	 */
+	int Run();
+
+	/**
+	 * \brief Handle ready descriptors once.
+	 * \param timeout Wait timeout in milliseconds, -1 waits forever.
+	 * \return Returns false on epoll failure.
+	 */
+	bool RunOnce(int timeout);
+
+	/**
+	 * \brief Make Run() return.
+	 */
+	void Quit();
+
+	/**
+	 * \brief Determine if HWDG answered on the open port.
+	 */
+	bool IsConnected() const;
+
+	/**
+	 * \brief Determine if Run() is about to return.
+	 */
+	bool IsQuitting() const;
+
+	std::function<void(const WatchdogStatus&)> OnConnected;
+	std::function<void()> OnDisconnected;
+	std::function<void(const WatchdogStatus&)> OnUpdated;
+	std::function<void(Response)> OnEvent;
+	std::function<void(const char*, int)> OnError;
+private:
+	void Connect();
+	void Disconnect();
+	bool Send(uint8_t command);
+	void ArmDeadline();
+	void OnSerial(uint32_t events);
+	void OnFrame(const SerialFrame& frame);
+	void OnStatus(const WatchdogStatus& status);
+	void OnPingTimer();
+	void OnStatusTimer();
+	void OnDeadlineTimer();
+	void OnSignal();
+	void ReportError(const char* what);
+	DaemonSettings settings;
+	SerialPort port;
+	SerialLink link;
+	int epoll;
+	int pingTimer;
+	int statusTimer;
+	int deadlineTimer;
+	int signals;
+	uint8_t state;
+	uint8_t nextTag;
+	uint8_t missed;
+	bool deadlineArmed;
+	bool quit;
+	bool stopping;
+	int lastError;
+	uint32_t lastStatus;
+	uint8_t commands[256];
+	uint64_t sentAt[256];
+};
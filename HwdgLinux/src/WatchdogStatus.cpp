@@ -0,0 +1,30 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include "WatchdogStatus.h"
+
+WatchdogStatus DecodeStatus(const uint8_t* data)
+{
+	WatchdogStatus status;
+	status.RebootTimeout = 10000 + (data[0] & 0x7F) * 5000;
+	status.ResponseTimeout = (((data[1] & 0xFC) >> 2) + 1) * 5000;
+	status.State = (data[1] & 3) | (data[2] & 1) << 2 | data[3] << 3;
+	status.SoftResetAttempts = (data[2] >> 5) + 1;
+	status.HardResetAttempts = ((data[2] >> 2) & 7) + 1;
+	status.RawData = (uint32_t)data[0] << 24 | data[1] << 16 | data[2] << 8 | data[3];
+	return status;
+}
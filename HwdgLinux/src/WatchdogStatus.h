@@ -0,0 +1,56 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+#include <stdint.h>
+
+// GetStatus status bytes, HWDG and HWDG Tiny share the layout
+#define STATUS_SIZE            ((uint8_t)4U)
+
+/**
+ * \brief HWDG state flags, the same as WatchdogState of HwdgWrapper.
+ */
+enum WatchdogState
+{
+	IsRunning = 1 << 0,
+	WaitingForReboot = 1 << 1,
+	HardResetEnabled = 1 << 2,
+	LedDisabled = 1 << 3,
+	EventsEnabled = 1 << 4,
+	LoadUserSettings = 1 << 5,
+	RstPulseEnabled = 1 << 6,
+	PwrPulseEnabled = 1 << 7,
+};
+
+/**
+ * \brief Decoded GetStatus response, timeouts are in milliseconds.
+ */
+struct WatchdogStatus
+{
+	uint32_t RawData;
+	uint8_t State;
+	uint32_t ResponseTimeout;
+	uint32_t RebootTimeout;
+	uint8_t HardResetAttempts;
+	uint8_t SoftResetAttempts;
+};
+
+/**
+ * \brief Decode status bytes of GetStatus response.
+ * \param data Status bytes, STATUS_SIZE of them.
+ */
+WatchdogStatus DecodeStatus(const uint8_t* data);
@@ -0,0 +1,84 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "WatchdogDaemon.h"
+
+/**
+ * \brief Serial HWDG daemon: keeps monitoring started and pings it while
+ * running, logs connection changes and events to stderr.
+ */
+
+static int Usage()
+{
+	fprintf(stderr,
+	        "usage: hwdgd -p /dev/ttyUSB0 [-b baudrate] [-i ping_ms] [-s status_ms]\n"
+	        "             [-t response_ms] [-n] [-E] [-k]\n"
+	        "  -n  do not start monitoring, only watch status and events\n"
+	        "  -E  do not enable events\n"
+	        "  -k  keep monitoring running when the daemon exits\n");
+	return 2;
+}
+
+static void PrintStatus(const char* what, const WatchdogStatus& status)
+{
+	fprintf(stderr, "%s: status %08X state %02X response %u ms reboot %u ms\n",
+	        what, status.RawData, status.State, status.ResponseTimeout, status.RebootTimeout);
+}
+
+int main(int argc, char** argv)
+{
+	DaemonSettings settings;
+	int option;
+	while ((option = getopt(argc, argv, "p:b:i:s:t:nEk")) != -1)
+	{
+		switch (option)
+		{
+		case 'p': settings.Port = optarg; break;
+		case 'b': settings.Baudrate = strtoul(optarg, nullptr, 10); break;
+		case 'i': settings.PingInterval = strtoul(optarg, nullptr, 10); break;
+		case 's': settings.StatusInterval = strtoul(optarg, nullptr, 10); break;
+		case 't': settings.ResponseTimeout = strtoul(optarg, nullptr, 10); break;
+		case 'n': settings.StartMonitoring = false; break;
+		case 'E': settings.EnableEvents = false; break;
+		case 'k': settings.StopOnExit = false; break;
+		default: return Usage();
+		}
+	}
+	if (settings.Port.empty() || settings.PingInterval == 0 || settings.StatusInterval == 0)
+		return Usage();
+
+	WatchdogDaemon daemon(settings);
+	daemon.OnConnected = [](const WatchdogStatus& status) { PrintStatus("connected", status); };
+	daemon.OnUpdated = [](const WatchdogStatus& status) { PrintStatus("updated", status); };
+	daemon.OnDisconnected = []() { fprintf(stderr, "disconnected\n"); };
+	daemon.OnEvent = [](Response event) { fprintf(stderr, "event %02X\n", event); };
+	daemon.OnError = [&settings](const char* what, int error)
+	{
+		fprintf(stderr, "%s: %s: %s\n", settings.Port.c_str(), what, strerror(error));
+	};
+
+	if (!daemon.Init() || !daemon.WatchSignals())
+	{
+		perror("hwdgd");
+		return 1;
+	}
+	return daemon.Run();
+}
@@ -0,0 +1,121 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgLinux.
+// 
+// HwdgLinux is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgLinux is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgLinux. If not, see <http://www.gnu.org/licenses/>.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HidrawDevice.h"
+#include "TinyClient.h"
+
+/**
+ * \brief Command line client: list devices, send commands, print status
+ * or events of HWDG Tiny.
+ */
+
+static int Usage()
+{
+	fprintf(stderr,
+	        "usage: hwdgtiny list\n"
+	        "       hwdgtiny [-d /dev/hidrawN] status\n"
+	        "       hwdgtiny [-d /dev/hidrawN] events\n"
+	        "       hwdgtiny [-d /dev/hidrawN] <command> [command...]\n"
+	        "commands are hex bytes, e.g. F9 to start and FB to ping\n");
+	return 2;
+}
+
+int main(int argc, char** argv)
+{
+	const std::vector<std::string> devices = HidrawDevice::Enumerate(TINY_VENDOR_ID, TINY_PRODUCT_ID, TINY_NAME);
+	if (argc == 2 && strcmp(argv[1], "list") == 0)
+	{
+		for (const std::string& device : devices)
+			printf("%s\n", device.c_str());
+		return 0;
+	}
+
+	int arg = 1;
+	std::string path = devices.empty() ? "" : devices.front();
+	if (argc > 2 && strcmp(argv[1], "-d") == 0)
+	{
+		path = argv[2];
+		arg = 3;
+	}
+	if (arg >= argc) return Usage();
+	if (path.empty())
+	{
+		fprintf(stderr, "no HWDG Tiny found\n");
+		return 1;
+	}
+
+	HidrawDevice device;
+	if (!device.Open(path))
+	{
+		fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+		return 1;
+	}
+	TinyClient client(device);
+
+	if (strcmp(argv[arg], "status") == 0)
+	{
+		WatchdogStatus status;
+		if (!client.GetStatus(status))
+		{
+			fprintf(stderr, "status: %s\n", strerror(errno));
+			return 1;
+		}
+		printf("raw %08X state %02X response %u ms reboot %u ms soft %u hard %u\n",
+		       status.RawData, status.State, status.ResponseTimeout, status.RebootTimeout,
+		       status.SoftResetAttempts, status.HardResetAttempts);
+		return 0;
+	}
+
+	if (strcmp(argv[arg], "events") == 0)
+	{
+		Response event;
+		int result;
+		while ((result = client.WaitEvent(event, -1)) > 0)
+		{
+			printf("%02X\n", event);
+			fflush(stdout);
+		}
+		fprintf(stderr, "events: %s\n", strerror(errno));
+		return 1;
+	}
+
+	std::vector<uint8_t> commands;
+	for (; arg < argc; arg++)
+	{
+		char* end;
+		const unsigned long command = strtoul(argv[arg], &end, 16);
+		if (*end != '\0' || command > 0xFF) return Usage();
+		commands.push_back((uint8_t)command);
+	}
+
+	std::vector<Response> responses(commands.size());
+	const bool result = commands.size() == 1
+		                    ? client.SendCommand(commands[0], responses[0])
+		                    : client.SendCommands(commands.data(), commands.size(), responses.data());
+	if (!result)
+	{
+		fprintf(stderr, "command: %s\n", strerror(errno));
+		return 1;
+	}
+	for (const Response response : responses)
+		printf("%02X\n", response);
+	return 0;
+}
@@ -0,0 +1,58 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include "../Hwdg/src/ChipReset.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace HwdgTests
+{
+	TEST_CLASS(ChipResetTests)
+	{
+	public:
+
+		/**
+		* \brief ID:500033 Verify reset without hardware flags is reported as power on.
+		*/
+		TEST_METHOD(VerifyChipResetNoFlagsMeansPowerOn)
+		{
+			// Arrange
+			ChipReset::SimulateResetFlags(0);
+
+			// Act & Assert
+			Assert::AreEqual(uint8_t(1U << CausePowerOn), ChipReset::GetResetCause());
+		}
+
+		/**
+		* \brief ID:500034 Verify reset flags are read once and kept for the whole power cycle.
+		*/
+		TEST_METHOD(VerifyChipResetCauseReadOnce)
+		{
+			// Arrange
+			const uint8_t cause = 1U << CauseWindowWatchdog | 1U << CauseIllegalOpcode;
+			ChipReset::SimulateResetFlags(cause);
+
+			// Act
+			const uint8_t first = ChipReset::GetResetCause();
+			const uint8_t second = ChipReset::GetResetCause();
+
+			// Assert
+			Assert::AreEqual(cause, first);
+			Assert::AreEqual(cause, second);
+		}
+	};
+}
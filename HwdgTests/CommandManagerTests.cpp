@@ -0,0 +1,197 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "fakeit.hpp"
+#include "CppUnitTest.h"
+
+#include "../Hwdg/src/CommandManager.h"
+// ReSharper disable once CppUnusedIncludeDirective
+#include "../Hwdg/src/CommandManager.cpp"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace fakeit;
+
+namespace HwdgTests
+{
+	TEST_CLASS(CommandManagerTests)
+	{
+		Mock<Uart> uart;
+		Mock<ResetController> controller;
+		Mock<SettingsManager> settings;
+		Mock<FrequencyScaler> scaler;
+
+		static void Wait(uint32_t ms)
+		{
+			for (uint32_t i = 0; i < ms; i++)
+				Timer::OnElapse();
+		}
+
+		void Arrange()
+		{
+			When(Method(uart, SubscribeOnByteReceived)).AlwaysReturn();
+			When(Method(uart, UnsubscribeOnByteReceived)).AlwaysReturn();
+			When(Method(uart, SendByte)).AlwaysReturn();
+			When(Method(controller, Ping)).AlwaysReturn(PingOk);
+			When(Method(controller, SetEscalationStage)).AlwaysReturn(SetEscalationStageOk);
+			When(Method(scaler, Boost)).AlwaysReturn();
+		}
+
+	public:
+
+		/**
+		* \brief ID:500045 Verify arguments that don't arrive in time are dropped.
+		*/
+		TEST_METHOD(VerifyCommandManagerDropsStaleArguments)
+		{
+			// Arrange
+			Arrange();
+			CommandManager manager(uart.get(), controller.get(), settings.get(), scaler.get());
+
+			// Act
+			manager.Callback(0x04);
+			manager.Callback(0x01);
+			Wait(ARGS_TIMEOUT + 1);
+			manager.Callback(0xFB);
+
+			// Assert
+			Verify(Method(controller, SetEscalationStage)).Never();
+			Verify(Method(controller, Ping)).Once();
+			Verify(Method(uart, SendByte).Using(PingOk)).Once();
+		}
+
+		/**
+		* \brief ID:500046 Verify arguments arriving within timeout complete the command.
+		*/
+		TEST_METHOD(VerifyCommandManagerCollectsArgumentsWithinTimeout)
+		{
+			// Arrange
+			Arrange();
+			CommandManager manager(uart.get(), controller.get(), settings.get(), scaler.get());
+
+			// Act
+			manager.Callback(0x04);
+			manager.Callback(0x01);
+			Wait(ARGS_TIMEOUT);
+			manager.Callback(0x41);
+			Wait(ARGS_TIMEOUT);
+			manager.Callback(0x02);
+
+			// Assert
+			Verify(Method(controller, SetEscalationStage).Using(0x01, 0x41, 0x02)).Once();
+			Verify(Method(uart, SendByte).Using(SetEscalationStageOk)).Once();
+		}
+
+		/**
+		* \brief ID:500050 Verify tagged command response follows TaggedResponse marker and the tag.
+		*/
+		TEST_METHOD(VerifyCommandManagerTaggedResponseOrder)
+		{
+			// Arrange
+			Arrange();
+			CommandManager manager(uart.get(), controller.get(), settings.get(), scaler.get());
+
+			// Act
+			manager.Callback(0x0D);
+			manager.Callback(0x2A);
+			manager.Callback(0xFB);
+			manager.Callback(0xFB);
+
+			// Assert
+			Verify(Method(uart, SendByte).Using(TaggedResponse)
+				+ Method(uart, SendByte).Using(0x2A)
+				+ Method(uart, SendByte).Using(PingOk)
+				+ Method(uart, SendByte).Using(PingOk)).Once();
+			Verify(Method(uart, SendByte)).Exactly(4);
+		}
+
+		/**
+		* \brief ID:500051 Verify tag applies to the next multibyte command once its arguments arrive.
+		*/
+		TEST_METHOD(VerifyCommandManagerTagsCommandWithArguments)
+		{
+			// Arrange
+			Arrange();
+			CommandManager manager(uart.get(), controller.get(), settings.get(), scaler.get());
+
+			// Act
+			manager.Callback(0x0D);
+			manager.Callback(0x07);
+			manager.Callback(0x04);
+			manager.Callback(0x01);
+			manager.Callback(0x41);
+			manager.Callback(0x02);
+
+			// Assert
+			Verify(Method(controller, SetEscalationStage).Using(0x01, 0x41, 0x02)).Once();
+			Verify(Method(uart, SendByte).Using(TaggedResponse)
+				+ Method(uart, SendByte).Using(0x07)
+				+ Method(uart, SendByte).Using(SetEscalationStageOk)).Once();
+			Verify(Method(uart, SendByte)).Exactly(3);
+		}
+
+		/**
+		* \brief ID:500049 Verify multibyte command received across CPU frequency switches leaves UART alone.
+		*/
+		TEST_METHOD(VerifyCommandManagerReceivesArgumentsAcrossBoost)
+		{
+			// Arrange
+			Arrange();
+			Timer timer;
+			FrequencyScaler realScaler(timer);
+			CommandManager manager(uart.get(), controller.get(), settings.get(), realScaler);
+			Wait(ARGS_TIMEOUT);
+			Assert::AreEqual(Freq2Mhz, Clock::GetCpuFreq());
+
+			// Act
+			manager.Callback(0x04);
+			Assert::AreEqual(Freq16Mhz, Clock::GetCpuFreq());
+			Wait(ARGS_TIMEOUT);
+			Assert::AreEqual(Freq2Mhz, Clock::GetCpuFreq());
+			manager.Callback(0x01);
+			Assert::AreEqual(Freq16Mhz, Clock::GetCpuFreq());
+			manager.Callback(0x41);
+			manager.Callback(0x02);
+
+			// Assert
+			Verify(Method(controller, SetEscalationStage).Using(0x01, 0x41, 0x02)).Once();
+			Verify(Method(uart, SubscribeOnByteReceived)).Once();
+			Verify(Method(uart, SendByte).Using(SetEscalationStageOk)).Once();
+			VerifyNoOtherInvocations(uart);
+			Clock::SetCpuFreq(Freq16Mhz);
+		}
+
+		/**
+		* \brief ID:500053 Verify broadcast address is rejected as board address.
+		*/
+		TEST_METHOD(VerifyCommandManagerRejectsBroadcastBusAddress)
+		{
+			// Arrange
+			Arrange();
+			When(Method(settings, SaveBusAddress)).AlwaysReturn(true);
+			CommandManager manager(uart.get(), controller.get(), settings.get(), scaler.get());
+
+			// Act
+			manager.Callback(0x0E);
+			manager.Callback(BUS_BROADCAST);
+			manager.Callback(0x0E);
+			manager.Callback(0x05);
+
+			// Assert
+			Verify(Method(settings, SaveBusAddress)).Once();
+			Verify(Method(uart, SendByte).Using(InvalidArgument)
+				+ Method(uart, SendByte).Using(SetBusAddressOk)).Once();
+		}
+	};
+}
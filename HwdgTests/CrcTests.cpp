@@ -0,0 +1,95 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <intrin.h>
+#include <stdio.h>
+
+#include "../Hwdg/src/Crc.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace HwdgTests
+{
+	TEST_CLASS(CrcTests)
+	{
+	public:
+		typedef uint8_t (*CrcEngine)(uint8_t* buffer, uint8_t length);
+
+		/**
+		* \brief ID:500043 Verify every CRC engine gives the same checksum.
+		*/
+		TEST_METHOD(VerifyCrcEnginesAgree)
+		{
+			// Arrange
+			uint8_t buffer[255];
+			for (uint16_t i = 0; i < sizeof buffer; i++)
+				buffer[i] = uint8_t(i * 167 + 13);
+
+			// Act & Assert
+			for (uint16_t length = 0; length <= sizeof buffer; length++)
+			{
+				const uint8_t expected = CrcCalculator::GetCrc7Table(buffer, uint8_t(length));
+				Assert::AreEqual(expected, CrcCalculator::GetCrc7Nibble(buffer, uint8_t(length)));
+				Assert::AreEqual(expected, CrcCalculator::GetCrc7Bitwise(buffer, uint8_t(length)));
+				Assert::AreEqual(expected, CrcCalculator::GetCrc7(buffer, uint8_t(length)));
+			}
+		}
+
+		/**
+		* \brief ID:500044 Benchmark CRC engines, reports host cycles per byte and table size.
+		* \remarks Code size of each engine comes from the target map file, host can't tell it.
+		*/
+		TEST_METHOD(BenchmarkCrcEngines)
+		{
+			const struct
+			{
+				const wchar_t* name;
+				CrcEngine engine;
+				uint16_t flash;
+			} engines[] = {
+				{ L"table", CrcCalculator::GetCrc7Table, 256 },
+				{ L"nibble", CrcCalculator::GetCrc7Nibble, 16 },
+				{ L"bitwise", CrcCalculator::GetCrc7Bitwise, 0 },
+			};
+			// Extended status response is the longest one CRC is calculated for.
+			const uint16_t rounds = 4096;
+			uint8_t buffer[48];
+			for (uint8_t i = 0; i < sizeof buffer; i++)
+				buffer[i] = uint8_t(i * 167 + 13);
+
+			for (const auto& e : engines)
+			{
+				// Act
+				uint8_t crc = 0;
+				const uint64_t start = __rdtsc();
+				for (uint16_t i = 0; i < rounds; i++)
+				{
+					buffer[0] = crc;
+					crc = e.engine(buffer, sizeof buffer);
+				}
+				const uint64_t cycles = __rdtsc() - start;
+
+				// Assert
+				Assert::AreEqual(CrcCalculator::GetCrc7Table(buffer, sizeof buffer), e.engine(buffer, sizeof buffer));
+				wchar_t message[128];
+				swprintf(message, sizeof message / sizeof message[0],
+					L"CRC7 %ls: %.2f cycles/byte, %u bytes flash, 0 bytes RAM\n",
+					e.name, double(cycles) / (double(rounds) * sizeof buffer), e.flash);
+				Logger::WriteMessage(message);
+			}
+		}
+	};
+}
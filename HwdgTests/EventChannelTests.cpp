@@ -0,0 +1,179 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "fakeit.hpp"
+#include "CppUnitTest.h"
+
+#include "../Hwdg/src/EventChannel.h"
+#include "../Hwdg/src/Crc.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace fakeit;
+
+namespace HwdgTests
+{
+	TEST_CLASS(EventChannelTests)
+	{
+		uint8_t frame[EVENT_FRAME_SIZE] = {};
+
+		void Capture(Mock<Uart>& uart)
+		{
+			When(Method(uart, SendData)).AlwaysDo([this](uint8_t* data, uint8_t len)
+			{
+				Assert::AreEqual(EVENT_FRAME_SIZE, len);
+				for (uint8_t i = 0; i < len; i++) frame[i] = data[i];
+			});
+		}
+
+		void AssertFrame(uint8_t sequence, Response event)
+		{
+			Assert::AreEqual(EVENT_MARKER, frame[0]);
+			Assert::AreEqual(sequence, frame[1]);
+			Assert::AreEqual(uint8_t(event), frame[2]);
+			Assert::AreEqual(CrcCalculator::GetCrc7(frame, EVENT_FRAME_SIZE - 1), frame[3]);
+		}
+
+		static void Tick(EventChannel& events, uint32_t ms)
+		{
+			for (uint32_t i = 0; i < ms; i++)
+				events.Tick();
+		}
+
+	public:
+		/**
+		* \brief ID:500028 Verify event stream sends heartbeat and events as sequenced frames.
+		*/
+		TEST_METHOD(VerifyEventStreamSendsSequencedFrames)
+		{
+			// Arrange
+			Mock<Uart> uart;
+			When(Method(uart, IsTxIdle)).AlwaysReturn(true);
+			Capture(uart);
+			EventChannel events(uart.get());
+			Assert::AreEqual(SetEventStreamOk, events.EnableStream(2));
+
+			// Act & Assert
+			Tick(events, 1999);
+			Verify(Method(uart, SendData)).Never();
+			Tick(events, 1);
+			Verify(Method(uart, SendData)).Once();
+			AssertFrame(1, WatchdogOk);
+
+			events.Post(FirstResetOccurred);
+			Tick(events, 1);
+			Verify(Method(uart, SendData)).Twice();
+			AssertFrame(2, FirstResetOccurred);
+			VerifyNoOtherInvocations(Method(uart, SendByte));
+		}
+
+		/**
+		* \brief ID:500029 Verify events of the same kind coalesce while UART is busy.
+		*/
+		TEST_METHOD(VerifyEventStreamCoalescesEvents)
+		{
+			// Arrange
+			Mock<Uart> uart;
+			When(Method(uart, IsTxIdle)).Return(false, true, true, true);
+			Capture(uart);
+			EventChannel events(uart.get());
+			events.EnableStream(0);
+
+			// Act
+			events.Post(SoftResetOccurred);
+			Tick(events, 1);
+			events.Post(SoftResetOccurred);
+			events.Post(MovedToIdle);
+			events.Post(SoftResetOccurred);
+			Tick(events, 1);
+
+			// Assert: coalesced event carries its latest sequence, frames keep sequence order.
+			Verify(Method(uart, SendData)).Once();
+			AssertFrame(3, MovedToIdle);
+			Tick(events, 1);
+			Verify(Method(uart, SendData)).Twice();
+			AssertFrame(4, SoftResetOccurred);
+			Tick(events, 1);
+			Verify(Method(uart, SendData)).Twice();
+		}
+
+		/**
+		* \brief ID:500030 Verify heartbeat may be turned off and disabled channel drops events.
+		*/
+		TEST_METHOD(VerifyEventStreamHeartbeatOff)
+		{
+			// Arrange
+			Mock<Uart> uart;
+			When(Method(uart, IsTxIdle)).AlwaysReturn(true);
+			Capture(uart);
+			EventChannel events(uart.get());
+
+			// Act & Assert
+			events.EnableStream(0);
+			Tick(events, 5000);
+			Verify(Method(uart, SendData)).Never();
+
+			Assert::AreEqual(DisableEventsOk, events.Disable());
+			events.Post(HardResetOccurred);
+			Tick(events, 1);
+			Verify(Method(uart, SendData)).Never();
+			Assert::IsFalse(events.IsEnabled());
+		}
+
+		/**
+		* \brief ID:500052 Verify no events are sent in bus mode.
+		*/
+		TEST_METHOD(VerifyEventChannelSilentInBusMode)
+		{
+			// Arrange
+			Mock<Uart> uart;
+			When(Method(uart, IsTxIdle)).AlwaysReturn(true);
+			Uart bus(9600);
+			bus.SetBusAddress(3);
+			EventChannel legacy(uart.get());
+			EventChannel stream(uart.get());
+			legacy.Enable();
+			stream.EnableStream(1);
+
+			// Act
+			legacy.Post(FirstResetOccurred);
+			stream.Post(FirstResetOccurred);
+			Tick(legacy, 1000);
+			Tick(stream, 1000);
+			bus.SetBusAddress(0);
+
+			// Assert
+			VerifyNoOtherInvocations(uart);
+		}
+
+		/**
+		* \brief ID:500054 Verify stream mode and period are reported for saving.
+		*/
+		TEST_METHOD(VerifyEventChannelReportsStream)
+		{
+			// Arrange
+			Mock<Uart> uart;
+			EventChannel events(uart.get());
+			uint8_t period = 0;
+
+			// Act & Assert
+			events.EnableStream(7);
+			Assert::IsTrue(events.IsStream(period));
+			Assert::AreEqual<uint8_t>(7, period);
+			events.Enable();
+			Assert::IsFalse(events.IsStream(period));
+			Assert::IsTrue(events.IsEnabled());
+		}
+	};
+}
@@ -0,0 +1,88 @@
+// Copyright 2017 Oleg Petrochenko
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "fakeit.hpp"
+#include "CppUnitTest.h"
+
+#include "../Hwdg/src/FrequencyScaler.h"
+
+#define HOLD_TIMEOUT 100U
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace fakeit;
+
+namespace HwdgTests
+{
+	TEST_CLASS(FrequencyScalerTests)
+	{
+		static void Wait(uint32_t ms)
+		{
+			for (uint32_t i = 0; i < ms; i++)
+				Timer::OnElapse();
+		}
+
+	public:
+
+		/**
+		* \brief ID:500035 Verify CPU drops to low frequency after hold timeout and boosts back on demand.
+		*/
+		TEST_METHOD(VerifyFrequencyScalerBoostAndDrop)
+		{
+			// Arrange
+			Timer timer;
+			Clock::SetCpuFreq(Freq16Mhz);
+			FrequencyScaler scaler(timer);
+
+			// Act & Assert
+			Wait(HOLD_TIMEOUT - 1);
+			Assert::AreEqual(Freq16Mhz, Clock::GetCpuFreq());
+			Wait(1);
+			Assert::AreEqual(Freq2Mhz, Clock::GetCpuFreq());
+
+			scaler.Boost();
+			Assert::AreEqual(Freq16Mhz, Clock::GetCpuFreq());
+
+			// Repeated boosts only extend hold timeout.
+			Wait(HOLD_TIMEOUT / 2);
+			scaler.Boost();
+			Wait(HOLD_TIMEOUT - 1);
+			Assert::AreEqual(Freq16Mhz, Clock::GetCpuFreq());
+			Wait(1);
+			Assert::AreEqual(Freq2Mhz, Clock::GetCpuFreq());
+			Clock::SetCpuFreq(Freq16Mhz);
+		}
+
+		/**
+		* \brief ID:500036 Verify CPU stays at low frequency until the next boost.
+		*/
+		TEST_METHOD(VerifyFrequencyScalerStaysLowWhileIdle)
+		{
+			// Arrange
+			Timer timer;
+			Clock::SetCpuFreq(Freq16Mhz);
+			FrequencyScaler scaler(timer);
+
+			// Act
+			Wait(HOLD_TIMEOUT * 3);
+
+			// Assert
+			Assert::AreEqual(Freq2Mhz, Clock::GetCpuFreq());
+			scaler.Boost();
+			Wait(HOLD_TIMEOUT - 1);
+			Assert::AreEqual(Freq16Mhz, Clock::GetCpuFreq());
+			Clock::SetCpuFreq(Freq16Mhz);
+		}
+	};
+}
@@ -199,15 +199,17 @@ namespace HwdgTests
 			for (auto i = 0; i < RST_TIM + 10; i++)
 				timer.OnElapse();
 
+			// Recall of the running action is merged with it, other
+			// actions wait in the queue until the running one completes.
 			rebooter.SoftReset();
-			for (auto i = 0; i < 50; i++)
+			for (auto i = 0; i < RST_TIM / 2; i++)
 				timer.OnElapse();
+			rebooter.SoftReset();
 			rebooter.HardReset();
-			for (auto i = 0; i < 50; i++)
+			for (auto i = 0; i < RST_TIM / 2; i++)
 				timer.OnElapse();
-
-			rebooter.SoftReset();
-			for (auto i = 0; i < 100; i++)
+			rebooter.HardReset();
+			for (auto i = 0; i < INFINITY_RB; i++)
 				timer.OnElapse();
 
 			// Assert
@@ -216,7 +218,14 @@ namespace HwdgTests
 				Method(driver, DrivePowerLow) +
 				Method(driver, ReleasePower) +
 				Method(driver, DriveResetLow) +
-				Method(driver, ReleaseReset)).Once();
+				Method(driver, ReleaseReset) +
+				Method(driver, DriveResetLow) +
+				Method(driver, ReleaseReset) +
+				Method(driver, DrivePowerLow) +
+				Method(driver, ReleasePower) +
+				Method(driver, DrivePowerLow) +
+				Method(driver, ReleasePower)).Once();
+			VerifyNoOtherInvocations(driver);
 		}
 
 		/**
@@ -236,9 +245,7 @@ namespace HwdgTests
 			// Act & assert
 			Assert::IsTrue(rebooter.PwrPulse() == PowerPulseOk);
 			Verify(Method(driver, DrivePowerLow)).Once();
-			Assert::IsTrue(rebooter.PwrPulse() == Busy);
-			Assert::IsTrue(rebooter.SoftReset() == Busy);
-			Assert::IsTrue(rebooter.HardReset() == Busy);
+			Assert::IsTrue(rebooter.PwrPulse() == PowerPulseOk);
 			Wait(RST_TIM - 1);
 			VerifyNoOtherInvocations(driver);
 			Wait(1);
@@ -254,5 +261,164 @@ namespace HwdgTests
 			Wait(INFINITY_RB);
 			VerifyNoOtherInvocations(driver);
 		}
+
+		/**
+		* \brief ID:500039 Verify queued actions follow each other with requested gaps and duplicates are merged.
+		*/
+		TEST_METHOD(VerifyRebooterQueuedActionsGapsAndCoalescing)
+		{
+			// Arrange
+			Mock<GpioDriver> driver;
+			When(Method(driver, DriveResetLow)).AlwaysReturn();
+			When(Method(driver, ReleaseReset)).AlwaysReturn();
+			When(Method(driver, DrivePowerLow)).AlwaysReturn();
+			When(Method(driver, ReleasePower)).AlwaysReturn();
+
+			Rebooter rebooter(timer, driver.get());
+
+			// Act & assert
+			Assert::IsTrue(rebooter.PwrPulse(100) == PowerPulseOk);
+			Assert::IsTrue(rebooter.SoftReset(50) == TestSoftResetOk);
+			Assert::IsTrue(rebooter.SoftReset() == TestSoftResetOk);
+			Assert::IsTrue(rebooter.HardReset() == TestHardResetOk);
+			VerifyNoOtherInvocations(driver);
+
+			Wait(100);
+			VerifyNoOtherInvocations(driver);
+			Wait(1);
+			Verify(Method(driver, DrivePowerLow)).Once();
+			Wait(RST_TIM);
+			Verify(Method(driver, ReleasePower)).Once();
+			Wait(49);
+			VerifyNoOtherInvocations(driver);
+			Wait(1);
+			Verify(Method(driver, DriveResetLow)).Once();
+			Wait(RST_TIM);
+			Verify(Method(driver, ReleaseReset)).Once();
+
+			// Hard reset had no gap requested, so it starts as soon as soft reset completes.
+			Verify(Method(driver, DrivePowerLow)).Twice();
+			Wait(INFINITY_RB);
+			Verify(Method(driver, DrivePowerLow)).Exactly(3);
+			Verify(Method(driver, ReleasePower)).Exactly(3);
+			Verify(Method(driver, DriveResetLow)).Once();
+			Verify(Method(driver, ReleaseReset)).Once();
+		}
+
+		/**
+		* \brief ID:500040 Verify listener is notified on completion and full queue rejects distinct actions.
+		*/
+		TEST_METHOD(VerifyRebooterCompletionListenerAndQueueCapacity)
+		{
+			// Arrange
+			Mock<GpioDriver> driver;
+			When(Method(driver, DriveResetLow)).AlwaysReturn();
+			When(Method(driver, ReleaseReset)).AlwaysReturn();
+			When(Method(driver, DrivePowerLow)).AlwaysReturn();
+			When(Method(driver, ReleasePower)).AlwaysReturn();
+			Mock<ISubscriber> listener;
+			When(Method(listener, Callback)).AlwaysReturn();
+
+			Rebooter rebooter(timer, driver.get());
+
+			// Act & assert
+			Assert::IsTrue(rebooter.SoftReset(0, &listener.get()) == TestSoftResetOk);
+			Assert::IsTrue(rebooter.PwrPulse(10) == PowerPulseOk);
+			Assert::IsTrue(rebooter.HardReset(10, &listener.get()) == TestHardResetOk);
+			Assert::IsTrue(rebooter.PwrPulse(10, &listener.get()) == PowerPulseOk);
+			Assert::IsTrue(rebooter.SoftReset(10) == TestSoftResetOk);
+			Assert::IsTrue(rebooter.SoftReset(10) == TestSoftResetOk);
+			Assert::IsTrue(rebooter.HardReset(10) == Busy);
+
+			Wait(RST_TIM);
+			Verify(Method(listener, Callback).Using(TestSoftResetOk)).Once();
+			Wait(INFINITY_RB);
+			Verify(Method(listener, Callback).Using(PowerPulseOk)).Once();
+			Verify(Method(listener, Callback).Using(TestHardResetOk)).Once();
+			Verify(Method(listener, Callback)).Exactly(3);
+		}
+
+		/**
+		* \brief ID:500041 Verify released line rise is sensed for healthy and slow pulses.
+		*/
+		TEST_METHOD(VerifyRebooterMeasuresLineRiseTime)
+		{
+			// Arrange
+			Mock<GpioDriver> driver;
+			bool held = false;
+			When(Method(driver, DriveResetLow)).AlwaysDo([] { GpioDriver::SimulateLineLevels(true, false); });
+			When(Method(driver, ReleaseReset)).AlwaysDo([&held] { if (!held) GpioDriver::SimulateLineLevels(false, false); });
+			When(Method(driver, DrivePowerLow)).AlwaysDo([] { GpioDriver::SimulateLineLevels(false, true); });
+			When(Method(driver, ReleasePower)).AlwaysDo([] { GpioDriver::SimulateLineLevels(false, false); });
+			GpioDriver::SimulateLineLevels(false, false);
+			Rebooter rebooter(timer, driver.get());
+			PulseStats stats;
+
+			// Act & assert
+			rebooter.SoftReset();
+			Wait(RST_TIM + 1);
+			rebooter.GetPulseStats(stats);
+			Assert::AreEqual(uint16_t(1), stats.pulses);
+			Assert::AreEqual(uint16_t(0), stats.failures);
+			Assert::AreEqual(uint16_t(1), stats.lastRiseTime);
+			Assert::AreEqual(uint16_t(RST_TIM), stats.lastDriveTime);
+
+			// Hard reset is driven over both low phases.
+			rebooter.HardReset();
+			Wait(INFINITY_RB);
+			rebooter.GetPulseStats(stats);
+			Assert::AreEqual(uint16_t(2), stats.pulses);
+			Assert::AreEqual(uint16_t(0), stats.failures);
+			Assert::AreEqual(uint16_t(1), stats.lastRiseTime);
+			Assert::AreEqual(uint16_t(HR_LO_TIM + RST_TIM), stats.lastDriveTime);
+
+			// Line rises slowly after release, but within timeout.
+			held = true;
+			rebooter.SoftReset();
+			Wait(RST_TIM + 3);
+			GpioDriver::SimulateLineLevels(false, false);
+			Wait(1);
+			rebooter.GetPulseStats(stats);
+			Assert::AreEqual(uint16_t(3), stats.pulses);
+			Assert::AreEqual(uint16_t(0), stats.failures);
+			Assert::AreEqual(uint16_t(4), stats.lastRiseTime);
+		}
+
+		/**
+		* \brief ID:500042 Verify lines not pulled up before the pulse or stuck low after release are counted as failed.
+		*/
+		TEST_METHOD(VerifyRebooterCountsFailedPulses)
+		{
+			// Arrange
+			Mock<GpioDriver> driver;
+			When(Method(driver, DrivePowerLow)).AlwaysReturn();
+			When(Method(driver, ReleasePower)).AlwaysReturn();
+			GpioDriver::SimulateLineLevels(false, true);
+			Rebooter rebooter(timer, driver.get());
+			PulseStats stats;
+
+			// Act & assert
+			// No pull-up, line isn't connected: failure is counted once.
+			rebooter.PwrPulse();
+			Wait(RST_TIM + RISE_TIMEOUT + 1);
+			rebooter.GetPulseStats(stats);
+			Assert::AreEqual(uint16_t(1), stats.pulses);
+			Assert::AreEqual(uint16_t(1), stats.failures);
+
+			// Line is pulled up before the pulse, but stays low after release.
+			GpioDriver::SimulateLineLevels(false, false);
+			rebooter.PwrPulse();
+			Wait(RST_TIM);
+			GpioDriver::SimulateLineLevels(false, true);
+			Wait(RISE_TIMEOUT - 1);
+			rebooter.GetPulseStats(stats);
+			Assert::AreEqual(uint16_t(2), stats.pulses);
+			Assert::AreEqual(uint16_t(1), stats.failures);
+			Wait(1);
+			rebooter.GetPulseStats(stats);
+			Assert::AreEqual(uint16_t(2), stats.failures);
+			Assert::AreEqual(uint16_t(RISE_TIMEOUT), stats.lastRiseTime);
+			GpioDriver::SimulateLineLevels(false, false);
+		}
 	};
 }
@@ -19,6 +19,8 @@
 #include "../Hwdg/src/Timer.h"
 #include "../Hwdg/src/ResetController.h"
 
+#include <random>
+
 #define RESPONSE_DEF_TIMEOUT 90000U
 #define REBOOT_DEF_TIMEOUT 150000U
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -1233,5 +1235,604 @@ namespace HwdgTests
 			Wait(15000);
 			Verify(Method(uart, SendByte).Using(Response::WatchdogOk)).Exactly(15);
 		}
+
+		/**
+		* \brief ID:500020 Verify escalation program may go straight to power cycle.
+		*/
+		TEST_METHOD(VerifyResetControllerEscalationPowerCycleOnly)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, HardReset)).AlwaysReturn();
+			When(Method(rebooter, PwrPulse)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Off)).AlwaysReturn();
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkFast)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+			When(Method(uart, SendByte)).AlwaysReturn();
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			Verify(Method(rebooter, GetTimer)).Once();
+
+			// Act
+			Assert::AreEqual(SetEscalationStageOk, rc.SetEscalationStage(0, ActionPowerCycle << 6 | 1, 0));
+			rc.Start();
+
+			for (auto i = 0; i < 2; i++)
+			{
+				// Act
+				if (i == 0) Wait(RESPONSE_DEF_TIMEOUT - 1);
+				else Wait(REBOOT_DEF_TIMEOUT - 1);
+
+				// Assert
+				VerifyNoOtherInvocations(rebooter);
+
+				// Act
+				Wait(1);
+
+				// Assert
+				Verify(Method(rebooter, HardReset)).Exactly(i + 1);
+				Verify(Method(rebooter, SoftReset)).Never();
+				Verify(Method(rebooter, PwrPulse)).Never();
+			}
+
+			// Act
+			Wait(REBOOT_DEF_TIMEOUT);
+
+			// Assert
+			Verify(Method(ledController, Glow)).Once();
+			Verify(Method(ledController, BlinkFast)).Once();
+
+			// Act
+			Wait(INFINITE);
+
+			// Assert
+			VerifyNoOtherInvocations(rebooter);
+		}
+
+		/**
+		* \brief ID:500021 Verify escalation program stages run in order with their own delays.
+		*/
+		TEST_METHOD(VerifyResetControllerEscalationStagesSequence)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, HardReset)).AlwaysReturn();
+			When(Method(rebooter, PwrPulse)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Off)).AlwaysReturn();
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkFast)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+			When(Method(uart, SendByte)).AlwaysReturn();
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			Verify(Method(rebooter, GetTimer)).Once();
+
+			// RST pulse, 10 s pause; wait 5 s; PWR pulse, reboot timeout pause.
+			rc.SetEscalationStage(0, ActionRstPulse << 6, 2);
+			rc.SetEscalationStage(1, ActionWait << 6, 1);
+			rc.SetEscalationStage(2, ActionPwrPulse << 6, 0);
+			rc.EnableEvents();
+			rc.Start();
+
+			// Act & Assert
+			Wait(RESPONSE_DEF_TIMEOUT);
+			Verify(Method(rebooter, SoftReset)).Once();
+			Verify(Method(uart, SendByte).Using(Response::FirstResetOccurred)).Once();
+
+			Wait(10000);
+			VerifyNoOtherInvocations(rebooter);
+
+			Wait(5000 - 1);
+			VerifyNoOtherInvocations(rebooter);
+			Wait(1);
+			Verify(Method(rebooter, PwrPulse)).Once();
+			Verify(Method(uart, SendByte).Using(Response::HardResetOccurred)).Once();
+
+			Wait(REBOOT_DEF_TIMEOUT);
+			Verify(Method(uart, SendByte).Using(Response::MovedToIdle)).Once();
+
+			Wait(INFINITE);
+			VerifyNoOtherInvocations(rebooter);
+			Verify(Method(rebooter, HardReset)).Never();
+		}
+
+		/**
+		* \brief ID:500022 Verify escalation program cannot be changed while running.
+		*/
+		TEST_METHOD(VerifyResetControllerEscalationStageValidation)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+
+			// Act & Assert
+			Assert::AreEqual(InvalidArgument, rc.SetEscalationStage(ESCALATION_STAGES, 0x41, 0));
+			Assert::AreEqual(SetEscalationStageOk, rc.SetEscalationStage(1, 0x41, 7));
+			Assert::AreEqual(uint8_t(0x41), rc.GetEscalation()[2]);
+			Assert::AreEqual(uint8_t(7), rc.GetEscalation()[3]);
+
+			rc.Start();
+			Assert::AreEqual(Busy, rc.SetEscalationStage(1, 0, 0));
+			rc.Stop();
+			Assert::AreEqual(SetEscalationStageOk, rc.SetEscalationStage(1, 0, 0));
+		}
+
+		/**
+		* \brief ID:500023 Verify first ping after reset re-arms monitoring when auto re-arm enabled.
+		*/
+		TEST_METHOD(VerifyResetControllerAutoRearmOnFirstPing)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, HardReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Off)).AlwaysReturn();
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkFast)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+			When(Method(uart, SendByte)).AlwaysReturn();
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			Verify(Method(rebooter, GetTimer)).Once();
+
+			Assert::AreEqual(EnableAutoRearmOk, rc.EnableAutoRearm());
+			Assert::AreEqual(uint32_t(0x0048449C), rc.GetStatus());
+			rc.Start();
+			Assert::AreEqual(Busy, rc.DisableAutoRearm());
+
+			// Act & Assert
+			Wait(RESPONSE_DEF_TIMEOUT);
+			Verify(Method(rebooter, SoftReset)).Once();
+
+			// Pings sent right after reset do not prove host recovered.
+			Wait(1000);
+			Assert::AreEqual(Busy, rc.Ping());
+
+			Wait(39000);
+			Assert::AreEqual(PingOk, rc.Ping());
+			Wait(1);
+			Assert::AreEqual(uint32_t(40000), rc.GetLastBootDuration());
+			Verify(Method(ledController, BlinkSlow)).Twice();
+			Assert::AreEqual(uint32_t(0x0048459C), rc.GetStatus());
+
+			// Monitoring restarted with all the attempts restored.
+			for (auto i = 0; i < 3; i++)
+			{
+				if (i == 0) Wait(RESPONSE_DEF_TIMEOUT - 2);
+				else Wait(REBOOT_DEF_TIMEOUT - 1);
+				Verify(Method(rebooter, SoftReset)).Exactly(i + 1);
+
+				Wait(1);
+				Verify(Method(rebooter, SoftReset)).Exactly(i + 2);
+			}
+
+			Wait(INFINITE);
+			Verify(Method(rebooter, SoftReset)).Exactly(4);
+			Verify(Method(rebooter, HardReset)).Never();
+		}
+
+		/**
+		* \brief ID:500047 Verify escalation steps shorter than REARM_MIN_TIMEOUT still let host re-arm.
+		*/
+		TEST_METHOD(VerifyResetControllerAutoRearmWithShortStages)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+			When(Method(uart, SendByte)).AlwaysReturn();
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+
+			// RST pulse repeated 8 times, 5 s apart.
+			rc.SetEscalationStage(0, 0x47, 1);
+			rc.EnableAutoRearm();
+			rc.Start();
+
+			// Act & Assert
+			Wait(RESPONSE_DEF_TIMEOUT);
+			Verify(Method(rebooter, SoftReset)).Once();
+
+			// Half the step still filters out pings sent before reset.
+			Wait(2000);
+			Assert::AreEqual(Busy, rc.Ping());
+
+			Wait(1000);
+			Assert::AreEqual(PingOk, rc.Ping());
+			Wait(1);
+			Assert::AreEqual(uint32_t(3000), rc.GetLastBootDuration());
+
+			// Monitoring restarted instead of the next escalation step.
+			Wait(RESPONSE_DEF_TIMEOUT - 2);
+			Verify(Method(rebooter, SoftReset)).Once();
+			Wait(1);
+			Verify(Method(rebooter, SoftReset)).Twice();
+			rc.Stop();
+		}
+
+		/**
+		* \brief ID:500024 Verify ping after reset is rejected when auto re-arm disabled.
+		*/
+		TEST_METHOD(VerifyResetControllerNoRearmByDefault)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			rc.Start();
+
+			// Act
+			Wait(RESPONSE_DEF_TIMEOUT + 40000);
+
+			// Assert
+			Assert::AreEqual(Busy, rc.Ping());
+			Wait(1);
+			Assert::AreEqual(uint32_t(40000), rc.GetLastBootDuration());
+			Wait(REBOOT_DEF_TIMEOUT - 40001);
+			Verify(Method(rebooter, SoftReset)).Twice();
+			rc.Stop();
+		}
+
+		/**
+		* \brief ID:500025 Verify reboot timeout adapts to learned boot duration and stays within bounds.
+		*/
+		TEST_METHOD(VerifyResetControllerAdaptiveRebootTimeout)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			rc.EnableAutoRearm();
+			Assert::AreEqual(SetAdaptiveRebootOk, rc.SetAdaptiveReboot(2, 0, 127));
+			rc.Start();
+
+			// Act & Assert: the first sample sets mean and half of it as deviation.
+			Wait(RESPONSE_DEF_TIMEOUT + 40000);
+			Assert::AreEqual(PingOk, rc.Ping());
+			Wait(1);
+			Assert::AreEqual(uint8_t(1), rc.GetBootSamples());
+			Assert::AreEqual(uint32_t(40000), rc.GetBootMean());
+			Assert::AreEqual(uint32_t(20000), rc.GetBootDeviation());
+			Assert::AreEqual(uint32_t(80000), rc.GetRebootTimeout());
+
+			// Act & Assert: the next sample moves estimates by 1/8 and 1/4 of error.
+			Wait(RESPONSE_DEF_TIMEOUT + 48000 - 1);
+			Assert::AreEqual(PingOk, rc.Ping());
+			Wait(1);
+			Assert::AreEqual(uint32_t(41000), rc.GetBootMean());
+			Assert::AreEqual(uint32_t(17000), rc.GetBootDeviation());
+			Assert::AreEqual(uint32_t(75000), rc.GetRebootTimeout());
+
+			// Act & Assert: effective timeout is clamped and drives the reset sequence.
+			rc.Stop();
+			Assert::AreEqual(SetAdaptiveRebootOk, rc.SetAdaptiveReboot(2, 0, 8));
+			Assert::AreEqual(uint32_t(50000), rc.GetRebootTimeout());
+			rc.DisableAutoRearm();
+			rc.Start();
+			Wait(RESPONSE_DEF_TIMEOUT + 50000 - 1);
+			Verify(Method(rebooter, SoftReset)).Exactly(3);
+			Wait(1);
+			Verify(Method(rebooter, SoftReset)).Exactly(4);
+			rc.Stop();
+		}
+
+		/**
+		* \brief ID:500026 Verify adaptive reboot settings survive export and import.
+		*/
+		TEST_METHOD(VerifyResetControllerAdaptiveRebootImportExport)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+			Mock<LedController> ledController;
+			Mock<Uart> uart;
+			const uint8_t saved[ADAPTIVE_REBOOT_SIZE] = { 3, 2, 20, 0x01, 0x90, 0x00, 0x64 };
+			uint8_t exported[ADAPTIVE_REBOOT_SIZE];
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			Assert::AreEqual(uint32_t(REBOOT_DEF_TIMEOUT), rc.GetRebootTimeout());
+
+			// Act
+			rc.ImportAdaptiveReboot(saved);
+			rc.ExportAdaptiveReboot(exported);
+
+			// Assert
+			Assert::AreEqual(uint8_t(3), rc.GetAdaptiveFactor());
+			Assert::AreEqual(uint32_t(40000), rc.GetBootMean());
+			Assert::AreEqual(uint32_t(10000), rc.GetBootDeviation());
+			Assert::AreEqual(uint32_t(70000), rc.GetRebootTimeout());
+			for (uint8_t i = 0; i < ADAPTIVE_REBOOT_SIZE; i++)
+				Assert::AreEqual(saved[i], exported[i]);
+		}
+
+		/**
+		* \brief ID:500027 Verify host that keeps pinging without activity on activity input gets reset.
+		*/
+		TEST_METHOD(VerifyResetControllerActivityLossTriggersReset)
+		{
+			// Arrange
+			GpioDriver driver;
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+			When(Method(rebooter, GetDriver)).AlwaysReturn(driver);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			Assert::AreEqual(SetActivityTimeoutOk, rc.SetActivityTimeout(2));
+			Assert::AreEqual(uint32_t(1U << 1), rc.GetStatus() >> 16 & 0x02);
+			rc.Start();
+			Assert::AreEqual(Busy, rc.SetActivityTimeout(0));
+
+			// Act: activity blinks while host pings.
+			for (uint8_t i = 0; i < 60; i++)
+			{
+				driver.SimulateActivityLevel(false);
+				Wait(250);
+				driver.SimulateActivityLevel(true);
+				Wait(250);
+				if (i % 10 == 0) rc.Ping();
+			}
+
+			// Assert
+			Assert::AreEqual(uint8_t(2), rc.GetActivityEdges());
+			Verify(Method(rebooter, SoftReset)).Never();
+
+			// Act: activity stops while host still pings.
+			for (uint8_t i = 0; i < 19; i++)
+			{
+				Wait(500);
+				rc.Ping();
+			}
+
+			// Assert
+			Assert::AreEqual(uint8_t(0), rc.GetActivityEdges());
+			Verify(Method(rebooter, SoftReset)).Never();
+			Wait(1000);
+			Verify(Method(rebooter, SoftReset)).Once();
+			rc.Stop();
+		}
+
+		/**
+		* \brief ID:500055 Verify busy activity input is not mistaken for idle one.
+		*/
+		TEST_METHOD(VerifyResetControllerActivityCountSaturates)
+		{
+			// Arrange
+			GpioDriver driver;
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+			When(Method(rebooter, GetDriver)).AlwaysReturn(driver);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			Assert::AreEqual(SetActivityTimeoutOk, rc.SetActivityTimeout(2));
+			rc.Start();
+
+			// Act: exactly 256 edges per window, pinging host.
+			for (uint8_t i = 0; i < 4; i++)
+			{
+				for (uint16_t j = 0; j < 256; j++)
+				{
+					driver.SimulateActivityLevel(false);
+					driver.SimulateActivityLevel(true);
+				}
+				Wait(1000);
+				rc.Ping();
+			}
+
+			// Assert
+			Assert::AreEqual(uint8_t(0xFF), rc.GetActivityEdges());
+			Verify(Method(rebooter, SoftReset)).Never();
+			rc.Stop();
+		}
+
+		/**
+		* \brief ID:500031 Verify snapshots stay consistent while timer interrupt preempts reader at random points.
+		*/
+		TEST_METHOD(VerifyResetControllerSnapshotStress)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			rc.SetResponseTimeout(0);
+			rc.SetRebootTimeout(2);
+			rc.SetSoftResetAttempts(7);
+			rc.EnableAutoRearm();
+			rc.Start();
+
+			// Simulated timer interrupt preempts reader between data reads
+			// and runs for random number of ticks.
+			static std::mt19937 random;
+			random.seed(1);
+			ResetController::preemption = []()
+			{
+				if (random() % 4 == 0) Wait(random() % 16384);
+			};
+
+			// Act: simulated UART interrupt pings, restarts idle controller and takes snapshots.
+			uint32_t failures = 0;
+			for (uint32_t i = 0; i < 5000; i++)
+			{
+				if (random() % 16 == 0) rc.Ping();
+				rc.Start();
+
+				ResetSnapshot snapshot;
+				rc.GetSnapshot(snapshot);
+				if (snapshot.counter >= snapshot.deadline) failures++;
+				if (snapshot.bootSamples && !snapshot.bootMean) failures++;
+			}
+			ResetController::preemption = nullptr;
+
+			// Assert
+			Assert::AreEqual(uint32_t(0), failures);
+			rc.Stop();
+		}
+
+		/**
+		* \brief ID:500048 Verify ping statistics are updated by timer even when reset controller is stopped.
+		*/
+		TEST_METHOD(VerifyResetControllerCountsPingsOnTimerTick)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			Wait(100);
+
+			// Act
+			Assert::AreEqual(Busy, rc.Ping());
+			Assert::AreEqual(Busy, rc.Ping());
+
+			// Assert
+			ResetSnapshot snapshot;
+			rc.GetSnapshot(snapshot);
+			Assert::AreEqual(uint32_t(0), snapshot.pings);
+			Assert::AreEqual(uint32_t(0xFFFFFFFF), snapshot.sincePing);
+
+			Wait(1);
+			Assert::AreEqual(uint32_t(1), rc.GetPings());
+			Wait(20);
+			rc.GetSnapshot(snapshot);
+			Assert::AreEqual(uint32_t(21), snapshot.sincePing);
+		}
+
+		/**
+		* \brief ID:500032 Verify snapshot reports uptime, ping and reset counters and time until next action.
+		*/
+		TEST_METHOD(VerifyResetControllerStatusCounters)
+		{
+			// Arrange
+			Mock<Rebooter> rebooter;
+			When(Method(rebooter, SoftReset)).AlwaysReturn();
+			When(Method(rebooter, GetTimer)).AlwaysReturn(timer);
+
+			Mock<LedController> ledController;
+			When(Method(ledController, Glow)).AlwaysReturn();
+			When(Method(ledController, BlinkMid)).AlwaysReturn();
+			When(Method(ledController, BlinkSlow)).AlwaysReturn();
+
+			Mock<Uart> uart;
+
+			ResetController rc(uart.get(), rebooter.get(), ledController.get());
+			rc.ImportResetCounters(10, 3);
+			ResetSnapshot snapshot;
+			rc.GetSnapshot(snapshot);
+			Assert::AreEqual(uint32_t(0xFFFFFFFF), snapshot.sincePing);
+			Assert::AreEqual(uint32_t(0xFFFFFFFF), snapshot.untilAction);
+
+			// Act
+			Wait(100);
+			rc.Start();
+			Wait(1000);
+			Assert::AreEqual(PingOk, rc.Ping());
+			Wait(500);
+
+			// Assert
+			rc.GetSnapshot(snapshot);
+			Assert::AreEqual(uint32_t(1600), snapshot.uptime);
+			Assert::AreEqual(uint32_t(1), rc.GetPings());
+			Assert::AreEqual(uint32_t(500), snapshot.sincePing);
+			Assert::AreEqual(uint32_t(RESPONSE_DEF_TIMEOUT - 500), snapshot.untilAction);
+			Assert::AreEqual(uint16_t(0), snapshot.softResets);
+
+			Wait(RESPONSE_DEF_TIMEOUT - 501);
+			Verify(Method(rebooter, SoftReset)).Never();
+			Wait(1);
+			Verify(Method(rebooter, SoftReset)).Once();
+			rc.GetSnapshot(snapshot);
+			Assert::AreEqual(uint16_t(1), snapshot.softResets);
+			Assert::AreEqual(uint16_t(0), snapshot.hardResets);
+			Assert::AreEqual(uint32_t(11), snapshot.totalSoftResets);
+			Assert::AreEqual(uint32_t(3), snapshot.totalHardResets);
+			Assert::AreEqual(uint32_t(REBOOT_DEF_TIMEOUT), snapshot.untilAction);
+
+			// Test resets are not counted.
+			rc.Stop();
+			rc.TestSoftReset();
+			rc.GetSnapshot(snapshot);
+			Assert::AreEqual(uint16_t(1), snapshot.softResets);
+		}
 	};
 }
@@ -46,5 +46,72 @@ namespace HwdgTests
 			fakeit::Verify(Method(subscriber, Callback)).Twice();
 			uart.UnsubscribeOnByteReceived();
 		}
+
+		/**
+		* \brief ID:500037 Verify bus mode delivers payload of own frames only.
+		*/
+		TEST_METHOD(VerifyBusModeFiltersForeignFrames)
+		{
+			// Arrange
+			fakeit::Mock<ISubscriber> subscriber;
+			fakeit::When(Method(subscriber, Callback)).AlwaysReturn();
+			auto& sb = subscriber.get();
+			Uart uart(9600);
+			uart.SubscribeOnByteReceived(sb);
+			uart.SetBusAddress(3);
+			const uint8_t frames[] = {
+				BUS_MARKER, 4, 2, 0xFB, 0xF8, // Frame for another board
+				BUS_MARKER, 3, 1, 0xFB,       // Own frame
+				0x55, 0xFB                    // Response of another board
+			};
+
+			// Act
+			for (uint8_t data : frames)
+			{
+				Uart::SimulateReceive(data);
+				uart.OnByteReceived();
+			}
+
+			// Assert
+			fakeit::Verify(Method(subscriber, Callback)).Once();
+			fakeit::Verify(Method(subscriber, Callback).Using(0xFB)).Once();
+			uart.SetBusAddress(0);
+			uart.UnsubscribeOnByteReceived();
+		}
+
+		/**
+		* \brief ID:500038 Verify bus mode accepts broadcast frames and resyncs on idle line.
+		*/
+		TEST_METHOD(VerifyBusModeAcceptsBroadcastAfterIdleLine)
+		{
+			// Arrange
+			fakeit::Mock<ISubscriber> subscriber;
+			fakeit::When(Method(subscriber, Callback)).AlwaysReturn();
+			auto& sb = subscriber.get();
+			Uart uart(9600);
+			uart.SubscribeOnByteReceived(sb);
+			uart.SetBusAddress(3);
+			const uint8_t noise[] = { 0x33, BUS_MARKER, 3 };
+			const uint8_t frame[] = { BUS_MARKER, BUS_BROADCAST, 1, 0xFA };
+
+			// Act
+			for (uint8_t data : noise)
+			{
+				Uart::SimulateReceive(data);
+				uart.OnByteReceived();
+			}
+			Uart::SimulateIdleLine();
+			for (uint8_t data : frame)
+			{
+				Uart::SimulateReceive(data);
+				uart.OnByteReceived();
+			}
+
+			// Assert
+			fakeit::Verify(Method(subscriber, Callback).Using(0xFA)).Once();
+			fakeit::Verify(Method(subscriber, Callback)).Once();
+			uart.SetBusAddress(0);
+			uart.UnsubscribeOnByteReceived();
+		}
 	};
 }
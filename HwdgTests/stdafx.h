@@ -11,3 +11,12 @@
 #include "CppUnitTest.h"
 
 // TODO: reference additional headers your program requires here
+#include "../Hwdg/src/Response.h"
+#include "../Hwdg/src/Clock.h"
+
+// Assert::AreEqual needs string conversion for firmware enums.
+namespace Microsoft { namespace VisualStudio { namespace CppUnitTestFramework
+{
+	template<> inline std::wstring ToString<Response>(const Response& t) { RETURN_WIDE_STRING(t); }
+	template<> inline std::wstring ToString<CpuFreq>(const CpuFreq& t) { RETURN_WIDE_STRING(t); }
+} } }
@@ -19,6 +19,16 @@
 #include "SettingsManager.h"
 #include "LedController.h"
 #include "ResetController.h"
+#include "Rebooter.h"
+#include "../Hwdg/src/WatchdogCore.h"
+
+// Delay before each startup pulse, the same as full version
+#define BOOT_PULSE_TIMEOUT  ((uint16_t)WDG_TICKS(3000UL))
+
+#if FEATURE_STARTUP_PULSES
+static uint8_t pulses;
+static uint16_t counter;
+#endif
 
 void BootManagerProceedBoot()
 {
@@ -35,10 +45,55 @@ void BootManagerProceedBoot()
 		ResetControllerSetRebootTimeout(settings.RebootTimeout);
 		ResetControllerSetResponseTimeout(settings.ResponseTimeout);
 		ResetControllerSetSoftResetAttempts(settings.ResetAttempts);
+#if FEATURE_HARD_RESET
+		ResetControllerSetHardResetAttempts(settings.HardResetAttempts);
+		if (settings.IsHardResetEnabled) ResetControllerEnableHardReset();
+#endif
+#if FEATURE_EVENTS
+		if (settings.IsEventsEnabled) ResetControllerEnableEvents();
+#endif
 	}
 	// Otherwise we just turn LED on.
 	else
 	{
 		LedControllerEnable();
 	}
+
+#if FEATURE_STARTUP_PULSES
+	// Pulses are sent few seconds apart from each other by
+	// BootManagerTimebase, so boot proceeds without waiting for them.
+	pulses = SettingsManagerGetBootSettings() & (PWR_PULSE_ENABLED | RST_PULSE_ENABLED);
+#endif
+}
+
+#if FEATURE_STARTUP_PULSES
+/**
+ * \brief This function must be called every 1ms.
+ */
+FEATURE_TEXT(startup_pulses) void BootManagerTimebase(void)
+{
+	if (!pulses || ++counter < BOOT_PULSE_TIMEOUT) return;
+
+	// Rebooter may be busy with a reset requested by the host,
+	// the pulse is retried on the next tick then
+	if (pulses & PWR_PULSE_ENABLED)
+	{
+		if (RebooterPwrPulse() == Busy)
+		{
+			counter--;
+			return;
+		}
+		pulses &= ~PWR_PULSE_ENABLED;
+	}
+	else
+	{
+		if (RebooterSoftReset() == Busy)
+		{
+			counter--;
+			return;
+		}
+		pulses = 0;
+	}
+	counter = 0;
 }
+#endif
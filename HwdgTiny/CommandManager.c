@@ -21,78 +21,195 @@
 #include "LedController.h"
 #include "SettingsManager.h"
 #include "Crc.h"
+#include "HardwareInit.h"
+#include <avr/pgmspace.h>
+#include <avr/wdt.h>
 
-static Response_t CommandManagerSaveCurrentSettings(void);
-static void GetSettings(void);
-static __inline void SendUnknownCommand(void);
+/**
+ * \brief Command handler, returns response to be sent.
+ */
+typedef Response_t (*Handler_t)(void);
+
+/**
+ * \brief Command dispatch table entry.
+ */
+typedef struct
+{
+	uint8_t Command;
+	Handler_t Handler;
+} Command_t;
+
+static Response_t IsAlive(void);
+static Response_t GetStatus(void);
+static Response_t SaveCurrentSettings(void);
+static void RestoreFactory(void) __attribute__((noreturn));
+#if FEATURE_STARTUP_PULSES
+static Response_t RstPulseOnStartupDisable(void);
+static Response_t RstPulseOnStartupEnable(void);
+static Response_t PwrPulseOnStartupDisable(void);
+static Response_t PwrPulseOnStartupEnable(void);
+#endif
+#if FEATURE_RESET_CAUSE
+static Response_t GetResetCauses(void);
+#endif
+static uint8_t GetFlags(void);
 extern Status_t HwdgStatus;
 
+/**
+ * \brief Commands without argument, a table in flash takes less
+ * space than a compare and call per command.
+ */
+static const Command_t commands[] PROGMEM =
+{
+	{ 0xFB, ResetControllerPing }, // Ping command
+	{ 0xF8, IsAlive }, // IsAlive command
+	{ 0x01, GetStatus }, // GetStatus command
+	{ 0xF9, ResetControllerStart }, // Start command
+	{ 0xFA, ResetControllerStop }, // Stop command
+	{ 0xFE, LedControllerEnable }, // Enable LED
+	{ 0xFF, LedControllerDisable }, // Disable LED
+	{ 0x7F, ResetControllerTestSoftReset }, // TestSoftReset command
+#if FEATURE_HARD_RESET
+	{ 0xFC, ResetControllerEnableHardReset }, // EnableHardReset command
+	{ 0xFD, ResetControllerDisableHardReset }, // DisableHardReset command
+	{ 0x7E, ResetControllerTestHardReset }, // TestHardReset command
+#endif
+#if FEATURE_EVENTS
+	{ 0x02, ResetControllerEnableEvents }, // EnableEvents command
+	{ 0x03, ResetControllerDisableEvents }, // DisableEvents command
+#endif
+#if FEATURE_STARTUP_PULSES
+	{ 0x3F, RstPulseOnStartupDisable }, // RstPulseOnStartupDisable command
+	{ 0x3E, RstPulseOnStartupEnable }, // RstPulseOnStartupEnable command
+	{ 0x3D, PwrPulseOnStartupDisable }, // PwrPulseOnStartupDisable command
+	{ 0x3C, PwrPulseOnStartupEnable }, // PwrPulseOnStartupEnable command
+#endif
+	{ 0x3B, SettingsManagerApplyUserSettingsAtStartup }, // ApplyUserSettingsAtStartup command
+	{ 0x3A, SettingsManagerLoadDefaultSettingsAtStartup }, // LoadDefaultSettingsAtStartup command
+	{ 0x39, SaveCurrentSettings }, // SaveCurrentSettings command
+#if FEATURE_RESET_CAUSE
+	{ 0x0C, GetResetCauses }, // GetResetCauses command
+#endif
+};
+
 void OnCommandReceived(uint8_t data)
 {
+	// Every command leaves its result in LastCommandStatus, the host
+	// reads it back with GET_REPORT or gets it pushed when tagged
+	if (data == 0xF7) // Restore factory settings
+		RestoreFactory();
 
-	data == 0xFB // Ping command
-		? ResetControllerPing()
-		//	: data == 0xF8 // IsAlive command
-		//	? SoftwareVersion
-		: data == 0x01 // GetStatus command
-		? GetSettings()
-		: data == 0xF9 // Start command
-		? ResetControllerStart()
-		: data == 0xFA // Stop command
-		? ResetControllerStop()
-		: data == 0xFE // Enable LED
-		? HwdgStatus.LastCommandStatus = LedControllerEnable()
-		: data == 0xFF // Disable LED
-		? HwdgStatus.LastCommandStatus = LedControllerDisable()
-		: data == 0x7F // TestSoftReset command
-		? ResetControllerTestSoftReset()
-
-
-		: data == 0x3B // ApplyUserSettingsAtStartup command
-		? SettingsManagerApplyUserSettingsAtStartup()
-		: data == 0x3A // LoadDefaultSettingsAtStartup command
-		? SettingsManagerLoadDefaultSettingsAtStartup()
-		: data == 0x39 // SaveCurrentSettings command
-		? CommandManagerSaveCurrentSettings()
-
-
-		: data >> 7 == 1 // SetRebootTimeout command
+	for (uint8_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+	{
+		if (pgm_read_byte(&commands[i].Command) == data)
+		{
+			HwdgStatus.LastCommandStatus = ((Handler_t)pgm_read_word(&commands[i].Handler))();
+			return;
+		}
+	}
+
+	HwdgStatus.LastCommandStatus =
+		data >> 7 == 1 // SetRebootTimeout command
 		? ResetControllerSetRebootTimeout(data)
 		: data >> 6 == 1 // SetResponseTimeout command
 		? ResetControllerSetResponseTimeout(data)
 		: data >> 3 == 2 // SetSoftResetAttempts command
 		? ResetControllerSetSoftResetAttempts(data)
-		: SendUnknownCommand();
+#if FEATURE_HARD_RESET
+		: data >> 3 == 3 // SetHardResetAttempts command
+		? ResetControllerSetHardResetAttempts(data)
+#endif
+		: UnknownCommand;
+}
+
+Response_t IsAlive(void)
+{
+	return SoftwareVersion;
+}
+
+/**
+ * \brief Get boot flags with actual LED and events state.
+ */
+uint8_t GetFlags(void)
+{
+	uint8_t flags = SettingsManagerGetBootSettings() & ~(LED_DISABLED | EVENTS_ENABLED);
+	if (!LedControllerIsEnabled())
+		flags |= LED_DISABLED;
+#if FEATURE_EVENTS
+	if (ResetControllerIsEventsEnabled())
+		flags |= EVENTS_ENABLED;
+#endif
+	return flags;
 }
 
-Response_t CommandManagerSaveCurrentSettings(void)
+Response_t SaveCurrentSettings(void)
 {
 	// Get ResetController status
 	uint8_t buffer[4];
 	*(uint32_t*)buffer = ResetControllerGetStatus();
+	buffer[3] = GetFlags();
 
-	// Get LED status.
-	if (LedControllerIsEnabled())
-	{
-		buffer[3] &= ~LED_DISABLED;
-	}
-	else
-	{
-		buffer[3] |= LED_DISABLED;
-	}
 	// Save all settings we got earlier
 	return SettingsManagerSaveUserSettings((Status_t*)buffer)
 		       ? SaveCurrentSettingsOk
 		       : SaveSettingsError;
 }
-void GetSettings(void)
+
+Response_t GetStatus(void)
+{
+	uint8_t* status = (uint8_t*)&HwdgStatus;
+	*(uint32_t*)status = ResetControllerGetStatus();
+	status[3] = GetFlags();
+	HwdgStatus.Checksum = GetCrc7(status, 4);
+	return (Response_t)0x00;
+}
+
+void RestoreFactory(void)
+{
+	// Restart with factory settings, there is no response like full version
+	SettingsManagerRestoreFactory();
+	wdt_enable(WDTO_15MS);
+	for (;;)
+		;
+}
+
+#if FEATURE_RESET_CAUSE
+/**
+ * \brief Get causes of the last chip reset.
+ * \remarks Returns the same ResetCause bit mask as the first byte of full
+ * version response. There is no room in flash for persisted counters.
+ */
+FEATURE_TEXT(reset_cause) Response_t GetResetCauses(void)
+{
+	uint8_t cause = 0;
+	if (ResetFlags & _BV(PORF)) cause |= 1 << 0; // CausePowerOn
+	if (ResetFlags & _BV(WDRF)) cause |= 1 << 2; // CauseIndependentWatchdog
+	if (ResetFlags & _BV(EXTRF)) cause |= 1 << 6; // CauseExternal
+	if (ResetFlags & _BV(BORF)) cause |= 1 << 7; // CauseBrownOut
+
+	// Power on is reported when no flag is set, as the full version does.
+	return (Response_t)(cause ? cause : 1 << 0);
+}
+#endif
+
+#if FEATURE_STARTUP_PULSES
+FEATURE_TEXT(startup_pulses) Response_t RstPulseOnStartupDisable(void)
+{
+	return SettingsManagerRstPulseOnStartup(0);
+}
+
+FEATURE_TEXT(startup_pulses) Response_t RstPulseOnStartupEnable(void)
 {
-	HwdgStatus = SettingsManagerObtainUserSettings();
-	HwdgStatus.Checksum = GetCrc7((uint8_t*)&HwdgStatus, 4);
-	HwdgStatus.LastCommandStatus = 0x00;
+	return SettingsManagerRstPulseOnStartup(1);
 }
 
-__inline void SendUnknownCommand(void)
+FEATURE_TEXT(startup_pulses) Response_t PwrPulseOnStartupDisable(void)
 {
-	HwdgStatus.LastCommandStatus = (uint8_t)UnknownCommand; 
-}
\ No newline at end of file
+	return SettingsManagerPwrPulseOnStartup(0);
+}
+
+FEATURE_TEXT(startup_pulses) Response_t PwrPulseOnStartupEnable(void)
+{
+	return SettingsManagerPwrPulseOnStartup(1);
+}
+#endif
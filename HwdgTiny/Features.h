@@ -0,0 +1,45 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgTiny.
+// 
+// HwdgTiny is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgTiny is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgTiny. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+// Optional features, drop them per SKU to fit smaller flash. Code
+// of every feature goes into its own .text.feature_<name> section,
+// so the linker map (HwdgTiny.map) shows what each one costs.
+
+#ifndef FEATURE_HARD_RESET
+// Hard reset through power button line, TestHardReset command
+#define FEATURE_HARD_RESET      1
+#endif
+
+#ifndef FEATURE_EVENTS
+// Reset and idle events pushed through interrupt-IN endpoint
+#define FEATURE_EVENTS          1
+#endif
+
+#ifndef FEATURE_STARTUP_PULSES
+// Reset and power button pulses after HWDG power on
+#define FEATURE_STARTUP_PULSES  1
+#endif
+
+#ifndef FEATURE_RESET_CAUSE
+// GetResetCauses command reporting why the chip itself restarted
+#define FEATURE_RESET_CAUSE     1
+#endif
+
+// Place function into the section of given feature
+#define FEATURE_TEXT(name)      __attribute__((section(".text.feature_" #name)))
@@ -23,11 +23,15 @@
 #define RST_DDR DDRB
 #define RST_PIN PINB
 
+#define PWR_DDR DDRB
+#define PWR_PORT PORTB
+
 #define LED_DDR DDRB
 #define LED_PIN PINB
 
 #define RST_VAL (1 << 3)
 #define LED_VAL (1 << 4)
+#define PWR_VAL (1 << 0)
 
 /**
 * \brief Initialize GPIO.
@@ -43,6 +47,9 @@ __inline void GpioInit(void)
 	// Ensure reset pins are in input mode.
 	RST_PIN &= ~RST_VAL;
 	RST_DDR &= ~RST_VAL;
+	// Power pin is open drain like reset one, output latch stays low.
+	PWR_PORT &= ~PWR_VAL;
+	PWR_DDR &= ~PWR_VAL;
 }
 
 /**
@@ -61,6 +68,22 @@ __inline void GpioReleaseReset(void)
 	RST_DDR &= ~RST_VAL;
 }
 
+/**
+* \brief Drive power pin low.
+*/
+__inline void GpioDrivePowerLow(void)
+{
+	PWR_DDR |= PWR_VAL;
+}
+
+/**
+* \brief Release power pin.
+*/
+__inline void GpioReleasePower(void)
+{
+	PWR_DDR &= ~PWR_VAL;
+}
+
 /**
 * \brief Drive LED pin low.
 * \note This function converts to a single sbi assembly
@@ -16,3 +16,19 @@
 // along with HwdgTiny. If not, see <http://www.gnu.org/licenses/>.
 
 #include "HardwareInit.h"
+#include <avr/wdt.h>
+
+uint8_t ResetFlags __attribute__((section(".noinit")));
+
+/**
+ * \brief Save and clear reset flags before C runtime starts.
+ * \remarks Watchdog stays enabled after watchdog reset while WDRF is set,
+ * so without this RestoreFactory restart would loop in resets forever.
+ */
+void ResetFlagsInit(void) __attribute__((naked, used, section(".init3")));
+void ResetFlagsInit(void)
+{
+	ResetFlags = MCUSR;
+	MCUSR = 0;
+	wdt_disable();
+}
@@ -22,6 +22,12 @@
 #include "Timer.h"
 #include "Gpio.h"
 #include "BootManager.h"
+#include "PowerManager.h"
+
+/**
+ * \brief MCUSR value saved at startup, MCUSR itself is cleared.
+ */
+extern uint8_t ResetFlags;
 
 /**
  * \brief Low level hardware initialization.
@@ -32,6 +38,7 @@ __inline void HardwareInit(void)
 	TimerInit();
 	GpioInit();
 	UsbInit();
+	PowerManagerInit();
 	BootManagerProceedBoot();
 	sei();
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgTiny.
+// 
+// HwdgTiny is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgTiny is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgTiny. If not, see <http://www.gnu.org/licenses/>.
+
+#include "PowerManager.h"
+#include "Timer.h"
+#include "usbconfig.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+#ifndef USB_SUSPEND_TICKS
+// Idle bus duration treated as suspend, USB allows
+// 3 ms of idle and requires suspend within 10 ms
+#define USB_SUSPEND_TICKS   ((uint8_t)5U)
+#endif
+
+// Watchdog interrupt period in power-down, 16 ms nominal
+// from 128 kHz oscillator, counted as ticks by Timer
+#define SLEEP_TICKS         ((uint8_t)16U)
+
+static volatile uint8_t idleTicks;
+static volatile uint8_t wakeup;
+
+void PowerManagerInit(void)
+{
+	// Low speed keep-alive toggles D- every frame, pin change flag
+	// catches it without an interrupt until we go to sleep
+	PCMSK |= 1 << USB_CFG_DMINUS_BIT;
+	GIFR = 1 << PCIF;
+}
+
+void PowerManagerSampleActivity(void)
+{
+	if (GIFR & 1 << PCIF)
+	{
+		GIFR = 1 << PCIF;
+		idleTicks = 0;
+	}
+	else if (idleTicks < USB_SUSPEND_TICKS)
+	{
+		idleTicks++;
+	}
+}
+
+void PowerManagerSleep(void)
+{
+	if (idleTicks < USB_SUSPEND_TICKS) return;
+
+	wakeup = 0;
+	GIFR = 1 << PCIF;
+	GIMSK |= 1 << PCIE;
+	// Timer0 stops in power-down, watchdog interrupt drives the timebase
+	WDTCR = 1 << WDCE | 1 << WDE;
+	WDTCR = 1 << WDIE;
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+
+	while (!wakeup)
+	{
+		cli();
+		if (!wakeup)
+		{
+			sleep_enable();
+			sei();
+			sleep_cpu();
+			sleep_disable();
+		}
+		sei();
+		// Reset FSM keeps running, a hung suspended host is reset too
+		TimerProcessTicks();
+	}
+
+	wdt_disable();
+	GIMSK &= ~(1 << PCIE);
+	idleTicks = 0;
+}
+
+ISR(PCINT0_vect)
+{
+	wakeup = 1;
+}
+
+ISR(WDT_vect, ISR_NOBLOCK)
+{
+	TimerAddTicks(SLEEP_TICKS);
+}
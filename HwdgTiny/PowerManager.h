@@ -0,0 +1,38 @@
+// Copyright 2018 Oleg Petrochenko
+// 
+// This file is part of HwdgTiny.
+// 
+// HwdgTiny is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+// 
+// HwdgTiny is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with HwdgTiny. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <stdint-gcc.h>
+
+/**
+ * \brief Start watching D- line for bus activity.
+ */
+void PowerManagerInit(void);
+
+/**
+ * \brief Sample bus activity. Must be called every 1ms from timer
+ * interrupt, so ticks processed late are not taken as idle bus.
+ */
+void PowerManagerSampleActivity(void);
+
+/**
+ * \brief Put MCU into power-down while host keeps the bus suspended.
+ * Watchdog timer keeps FSM timebase running, bus activity wakes MCU up.
+ * Must be called from the main loop.
+ */
+void PowerManagerSleep(void);
@@ -18,19 +18,30 @@
 #include "Rebooter.h"
 #include <stdint-gcc.h>
 #include "Gpio.h"
+#include "../Hwdg/src/WatchdogCore.h"
 
 // Soft reset pin low level duration
-#define RST_TIM             ((uint8_t)200U)
+#define RST_TIM             ((uint16_t)RST_PULSE)
+// Hard reset power pin low level duration
+#define HR_LO_TIM           ((uint16_t)HR_OFF_PULSE)
+// Hard reset power pin high level duration
+#define HR_HI_TIM           ((uint16_t)HR_ON_DELAY)
 
 // Reboot is in proccess
 #define IN_PROCESS          ((uint8_t)0x10U)
 // Soft reset token
 #define SOFT_RESET          ((uint8_t)0x01U)
+// Hard reset token
+#define HARD_RESET          ((uint8_t)0x02U)
+// Hard reset power off stage elapsed
+#define HR_LO_ELAPSED       ((uint8_t)0x04U)
+// Power pulse token, also the last stage of hard reset
+#define POWER_PULSE         ((uint8_t)0x20U)
 // Reset value
 #define INITIAL             ((uint8_t)0x00U)
 
 static uint8_t state;
-static uint8_t counter;
+static uint16_t counter;
 
 /**
 * \brief Start soft reset sequence.
@@ -44,14 +55,65 @@ Response_t RebooterSoftReset(void)
 	return TestSoftResetOk;
 }
 
+#if FEATURE_HARD_RESET
+FEATURE_TEXT(hard_reset) Response_t RebooterHardReset(void)
+{
+	if (state & IN_PROCESS) return Busy;
+	state = IN_PROCESS | HARD_RESET;
+	GpioDrivePowerLow();
+	counter = INITIAL;
+	return TestHardResetOk;
+}
+#endif
+
+#if FEATURE_HARD_RESET || FEATURE_STARTUP_PULSES
+Response_t RebooterPwrPulse(void)
+{
+	if (state & IN_PROCESS) return Busy;
+	state = IN_PROCESS | POWER_PULSE;
+	GpioDrivePowerLow();
+	counter = INITIAL;
+	return PowerPulseOk;
+}
+#endif
+
 /**
  * \brief This function must be called every 1ms.
  */
 void RebooterTimebase()
 {
-	if (state & SOFT_RESET && ++counter >= RST_TIM)
+	if (!(state & IN_PROCESS)) return;
+	counter++;
+
+	if (state & SOFT_RESET)
 	{
+		if (counter < RST_TIM) return;
 		GpioReleaseReset();
 		state = INITIAL;
 	}
+#if FEATURE_HARD_RESET || FEATURE_STARTUP_PULSES
+	else if (state & POWER_PULSE)
+	{
+		if (counter < RST_TIM) return;
+		GpioReleasePower();
+		state = INITIAL;
+	}
+#endif
+#if FEATURE_HARD_RESET
+	// Hold power button to force power off, then
+	// wait and press it shortly to power on again
+	else if (!(state & HR_LO_ELAPSED))
+	{
+		if (counter < HR_LO_TIM) return;
+		GpioReleasePower();
+		state |= HR_LO_ELAPSED;
+		counter = INITIAL;
+	}
+	else if (counter >= HR_HI_TIM)
+	{
+		GpioDrivePowerLow();
+		state = IN_PROCESS | POWER_PULSE;
+		counter = INITIAL;
+	}
+#endif
 }
@@ -17,8 +17,23 @@
 
 #pragma once
 #include "Common.h"
+#include "Features.h"
 
 /**
 * \brief Start soft reset sequence.
 */
 Response_t RebooterSoftReset(void);
+
+#if FEATURE_HARD_RESET
+/**
+* \brief Start hard reset sequence: force power off, then power on.
+*/
+Response_t RebooterHardReset(void);
+#endif
+
+#if FEATURE_HARD_RESET || FEATURE_STARTUP_PULSES
+/**
+* \brief Press power button shortly.
+*/
+Response_t RebooterPwrPulse(void);
+#endif
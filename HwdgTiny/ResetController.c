@@ -18,56 +18,63 @@
 #include "ResetController.h"
 #include "LedController.h"
 #include "Rebooter.h"
+#include "usbDriver.h"
+#include "../Hwdg/src/WatchdogCore.h"
 
 // Default response timeout, ms
-#define RESPONSE_DEF_TIMEOUT   ((uint32_t)10000UL/2)
+#define RESPONSE_DEF_TIMEOUT   WDG_TICKS(10000UL)
 // Default reboot timeout, ms
-#define REBOOT_DEF_TIMEOUT     ((uint32_t)15000UL/2)
-// Least reboot timeout value, ms
-#define REBOOT_MIN_TIMEOUT     ((uint32_t)10000UL/2)
-// Soft reset time base, ms
-#define SR_TIMEBASE            ((uint32_t)5000UL/2)
-// Hard reset time base, ms
-#define HR_TIMEBASE            ((uint32_t)5000UL)
+#define REBOOT_DEF_TIMEOUT     WDG_TICKS(15000UL)
 // Default soft reset attempts count
 #define SR_ATTEMPTS            ((uint8_t)3U)
+// Default hard reset attempts count
+#define HR_ATTEMPTS            ((uint8_t)3U)
 
 // RSM enabled
 #define ENABLED                ((uint8_t)(1U << 0U))
 // Response timeout elapsed
 #define RESPONSE_ELAPSED       ((uint8_t)(1U << 1U))
+// Hard reset enabled
+#define HR_ENABLED             ((uint8_t)(1U << 2U))
 // Response timeout elapsed
 #define HDD_MONITOR            ((uint8_t)(1U << 3U))
 // Response timeout elapsed
 #define LED_STARDED            ((uint8_t)(1U << 4U))
+// Events are pushed to the host
+#define EVENTS                 ((uint8_t)(1U << 5U))
 
-
-// Mask applied to extract attempts value
-#define ATTEMPTS_MASK          ((uint8_t)0x07U)
-// Mask applied to extract reboot timeout value
-#define REBOOT_MASK            ((uint8_t)0x7FU)
-// Mask applied to extract response timeout value
-#define RESPONSE_MASK          ((uint8_t)0x3FU)
 // Reset value
 #define INITIAL                ((uint8_t)0x00U)
-// hwdg event WatchdogOk elapse timeout
-#define EVENT_HWDGOK_TIMEOUT   ((uint16_t)1000)
 
 static uint32_t counter = INITIAL;
-static uint16_t counterms = INITIAL;
 static uint_least8_t state = INITIAL;
 static uint32_t responseTimeout = RESPONSE_DEF_TIMEOUT;
 static uint32_t rebootTimeout = REBOOT_DEF_TIMEOUT;
 static uint8_t sAttempt = SR_ATTEMPTS;
 static uint8_t sAttemptCurr = SR_ATTEMPTS;
+static uint8_t hAttempt = HR_ATTEMPTS;
+static uint8_t hAttemptCurr = HR_ATTEMPTS;
 
+#if FEATURE_EVENTS
+/**
+ * \brief Push event to the host if events are enabled.
+ */
+static void Notify(uint8_t event)
+{
+	if (state & EVENTS)
+		UsbNotify(event);
+}
+#else
+#define Notify(event)
+#endif
 
 uint32_t ResetControllerGetStatus(void)
 {
 	uint32_t result = INITIAL;
 	uint8_t* rs = (uint8_t*)&result;
-	rs[1] = (responseTimeout / SR_TIMEBASE - 1) << 2 | (state & 0x03);
-	rs[2] = (sAttemptCurr - 1) << 5 | (state & 0x0C) >> 2;
+	rs[0] = WdgRebootTimeoutCode(rebootTimeout);
+	rs[1] = WdgResponseTimeoutCode(responseTimeout) << 2 | (state & 0x03);
+	rs[2] = (sAttemptCurr - 1) << 5 | (hAttemptCurr - 1) << 2 | (state & 0x0C) >> 2;
 	return result;
 }
 
@@ -78,6 +85,7 @@ Response_t ResetControllerStart(void)
 	state &= ~(ENABLED | RESPONSE_ELAPSED | LED_STARDED);
 	state |= ENABLED;
 	sAttempt = sAttemptCurr;
+	hAttempt = hAttemptCurr;
 	LedControllerBlinkSlow();
 	return StartOk;
 }
@@ -99,21 +107,21 @@ Response_t ResetControllerPing(void)
 Response_t ResetControllerSetResponseTimeout(const uint8_t timeout)
 {
 	if (state & ENABLED) return Busy;
-	responseTimeout = ((timeout & RESPONSE_MASK) + 1) * SR_TIMEBASE;
+	responseTimeout = WdgResponseTimeout(timeout);
 	return SetResponseTimeoutOk;
 }
 
 Response_t ResetControllerSetRebootTimeout(const uint8_t timeout)
 {
 	if (state & ENABLED) return Busy;
-	rebootTimeout = REBOOT_MIN_TIMEOUT + (timeout & REBOOT_MASK) * HR_TIMEBASE;
+	rebootTimeout = WdgRebootTimeout(timeout);
 	return SetRebootTimeoutOk;
 }
 
 Response_t ResetControllerSetSoftResetAttempts(const uint8_t attempts)
 {
 	if (state & ENABLED) return Busy;
-	sAttemptCurr = (attempts & ATTEMPTS_MASK) + 1;
+	sAttemptCurr = WdgAttempts(attempts);
 	return SetSoftResetAttemptsOk;
 }
 
@@ -123,6 +131,54 @@ Response_t ResetControllerTestSoftReset(void)
 	return RebooterSoftReset();
 }
 
+#if FEATURE_HARD_RESET
+FEATURE_TEXT(hard_reset) Response_t ResetControllerEnableHardReset(void)
+{
+	if (state & ENABLED) return Busy;
+	state |= HR_ENABLED;
+	return EnableHardResetOk;
+}
+
+FEATURE_TEXT(hard_reset) Response_t ResetControllerDisableHardReset(void)
+{
+	if (state & ENABLED) return Busy;
+	state &= ~HR_ENABLED;
+	return DisableHardResetOk;
+}
+
+FEATURE_TEXT(hard_reset) Response_t ResetControllerSetHardResetAttempts(const uint8_t attempts)
+{
+	if (state & ENABLED) return Busy;
+	hAttemptCurr = WdgAttempts(attempts);
+	return SetHardResetAttemptsOk;
+}
+
+FEATURE_TEXT(hard_reset) Response_t ResetControllerTestHardReset(void)
+{
+	ResetControllerStop();
+	return RebooterHardReset();
+}
+#endif
+
+#if FEATURE_EVENTS
+FEATURE_TEXT(events) Response_t ResetControllerEnableEvents(void)
+{
+	state |= EVENTS;
+	return EnableEventsOk;
+}
+
+FEATURE_TEXT(events) Response_t ResetControllerDisableEvents(void)
+{
+	state &= ~EVENTS;
+	return DisableEventsOk;
+}
+
+uint8_t ResetControllerIsEventsEnabled(void)
+{
+	return state & EVENTS;
+}
+#endif
+
 /**
  * \brief This function must be called every 1ms.
  */
@@ -140,6 +196,7 @@ void ResetControllerTimebase(void)
 		RebooterSoftReset();
 		LedControllerBlinkMid();
 		state |= RESPONSE_ELAPSED;
+		Notify(FirstResetOccurred);
 	}
 	else if (state & RESPONSE_ELAPSED && counter >= rebootTimeout)
 	{
@@ -148,11 +205,26 @@ void ResetControllerTimebase(void)
 		{
 			sAttempt--;
 			RebooterSoftReset();
+			Notify(SoftResetOccurred);
+		}
+#if FEATURE_HARD_RESET
+		else if (state & HR_ENABLED && hAttempt > 0)
+		{
+			hAttempt--;
+			if (!(state & LED_STARDED))
+			{
+				state |= LED_STARDED;
+				LedControllerBlinkFast();
+			}
+			RebooterHardReset();
+			Notify(HardResetOccurred);
 		}
+#endif
 		else
 		{
 			LedControllerGlow();
 			state &= ~(ENABLED | RESPONSE_ELAPSED | LED_STARDED);
+			Notify(MovedToIdle);
 		}
 	}
 }
@@ -19,6 +19,7 @@
 
 #include <stdint-gcc.h>
 #include "Common.h"
+#include "Features.h"
 
 /**
 * \brief Gets ResetController status.
@@ -69,3 +70,44 @@ Response_t ResetControllerSetSoftResetAttempts(uint8_t attempts);
 * \brief Test soft reset.
 */
 Response_t ResetControllerTestSoftReset(void);
+
+#if FEATURE_HARD_RESET
+/**
+* \brief Allow watchdog restart computer via power button.
+* \remarks see https://hwdg.ru/developer/hwdg-api/enablehardreset/ for more details.
+*/
+Response_t ResetControllerEnableHardReset(void);
+
+/**
+* \brief Disable watchdog restart computer via power button.
+*/
+Response_t ResetControllerDisableHardReset(void);
+
+/**
+* \brief Set hard reset attempts count.
+* \param attempts Attempts count.
+*/
+Response_t ResetControllerSetHardResetAttempts(uint8_t attempts);
+
+/**
+* \brief Test hard reset.
+*/
+Response_t ResetControllerTestHardReset(void);
+#endif
+
+#if FEATURE_EVENTS
+/**
+* \brief Push reset and idle events to the host.
+*/
+Response_t ResetControllerEnableEvents(void);
+
+/**
+* \brief Stop pushing events to the host.
+*/
+Response_t ResetControllerDisableEvents(void);
+
+/**
+* \brief Check whether events are pushed to the host.
+*/
+uint8_t ResetControllerIsEventsEnabled(void);
+#endif
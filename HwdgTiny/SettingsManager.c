@@ -17,82 +17,93 @@
 
 #include "SettingsManager.h"
 #include <avr/eeprom.h>
-#define DEFAULT_SETTINGS ((uint32_t)0x1C444800)
+#define DEFAULT_SETTINGS ((uint32_t)SETTINGS_DEFAULT_3 << 24 | (uint32_t)SETTINGS_DEFAULT_2 << 16 \
+	| (uint32_t)SETTINGS_DEFAULT_1 << 8 | SETTINGS_DEFAULT_0)
 
 #define EEPROM_ADDR (uint32_t *)0
+// Boot settings flags are kept in the last byte of settings dword
+#define BOOT_ADDR (uint8_t *)3
+// Oscillator calibration is kept right after the settings dword
+#define OSCCAL_ADDR (uint8_t *)4
+
+/**
+ * \brief Set or clear boot settings flag.
+ * \param flag Flag to be changed.
+ * \param value Non-zero sets the flag, zero clears it.
+ * \param ok Response returned on success.
+ * \return Returns ok if flag has desired value, otherwise SaveSettingsError.
+ */
+static Response_t SetBootFlag(const uint8_t flag, const uint8_t value, const Response_t ok)
+{
+	// If we have the same values in EEPROM we don't need to
+	// rewrite existing data, just say operation succeeded.
+	uint8_t saved = eeprom_read_byte(BOOT_ADDR);
+	const uint8_t desired = value ? saved | flag : saved & ~flag;
+	if (saved == desired)
+		return ok;
+
+	// Write data to EEPROM.
+	eeprom_write_byte(BOOT_ADDR, desired);
+
+	// Verify write operation succeeded.
+	return eeprom_read_byte(BOOT_ADDR) == desired
+		       ? ok
+		       : SaveSettingsError;
+}
+
 uint8_t SettingsManagerSaveUserSettings(Status_t* status)
 {
-	Status_t actual = *status;
 	// As we save only sttings, we dont need to save
 	// IsRebooting and IsMonitoring flags and checksum.
-	// Following code is the same if we just called:
-	// actual.IsRebooting = 0;
-	// actual.IsMonitoring = 0;
-	// We save couple of bytes applying bit mask. 
-	uint8_t* actual_p = (uint8_t*)&actual;
-	actual_p[1] &= 0x3F;
+	uint32_t actual = *(uint32_t*)status;
+	((uint8_t*)&actual)[1] &= ~0x03;
 
 	const uint32_t saved = eeprom_read_dword(EEPROM_ADDR);
 
 	// If we have the same values in EEPROM we don't need to
 	// rewrite existing data, just say operation succeeded.
-	if(saved == (uint32_t)*actual_p)
+	if (saved == actual)
 		return 1;
 
 	// Write data to EEPROM.
-	eeprom_write_dword(EEPROM_ADDR, (uint32_t)*actual_p);
+	eeprom_write_dword(EEPROM_ADDR, actual);
 
 	// Verify write operation succeeded.
-	return !((uint32_t)*actual_p == eeprom_read_dword(EEPROM_ADDR));
+	return actual == eeprom_read_dword(EEPROM_ADDR);
 }
 
 Status_t SettingsManagerObtainUserSettings(void)
 {
-	uint32_t result = eeprom_read_dword(EEPROM_ADDR);
-	return *(Status_t*)&result;
+	Status_t result;
+	*(uint32_t*)&result = eeprom_read_dword(EEPROM_ADDR);
+	return result;
 }
 
 Response_t SettingsManagerApplyUserSettingsAtStartup(void)
 {
-	// If we have the same values in EEPROM we don't need to
-	// rewrite existing data, just say operation succeeded.
-	uint32_t saved = eeprom_read_dword(EEPROM_ADDR);
-	Status_t* saved_p = (Status_t*)&saved;
-	
-	if (saved_p->LoadUserSettings)
-		return ApplyUserSettingsAtStartupOk;
-
-	// Write data to EEPROM.
-	saved_p->LoadUserSettings = 1;
-	eeprom_write_dword(EEPROM_ADDR, saved);
-
-	// Verify write operation succeeded.	
-	saved = eeprom_read_dword(EEPROM_ADDR);
-	return saved_p->LoadUserSettings
-		       ? ApplyUserSettingsAtStartupOk
-		       : SaveSettingsError;
+	return SetBootFlag(APPLY_SETTINGS_AT_STARTUP, 1, ApplyUserSettingsAtStartupOk);
 }
 
 Response_t SettingsManagerLoadDefaultSettingsAtStartup(void)
 {
-	// If we have the same values in EEPROM we don't need to
-	// rewrite existing data, just say operation succeeded.
-	uint32_t saved = eeprom_read_dword(EEPROM_ADDR);
-	Status_t* saved_p = (Status_t*)&saved;
+	return SetBootFlag(APPLY_SETTINGS_AT_STARTUP, 0, LoadDefaultSettingsAtStartupOk);
+}
 
-	if (!saved_p->LoadUserSettings)
-		return LoadDefaultSettingsAtStartupOk;
+#if FEATURE_STARTUP_PULSES
+FEATURE_TEXT(startup_pulses) Response_t SettingsManagerRstPulseOnStartup(const uint8_t enable)
+{
+	return enable
+		       ? SetBootFlag(RST_PULSE_ENABLED, 1, RstPulseOnStartupEnableOk)
+		       : SetBootFlag(RST_PULSE_ENABLED, 0, RstPulseOnStartupDisableOk);
+}
 
-	// Write data to EEPROM.
-	saved_p->LoadUserSettings = 0;
-	eeprom_write_dword(EEPROM_ADDR, saved);
-	
-	// Verify write operation succeeded.	
-	saved = eeprom_read_dword(EEPROM_ADDR);
-	return !saved_p->LoadUserSettings
-		       ? LoadDefaultSettingsAtStartupOk
-		       : SaveSettingsError;
+FEATURE_TEXT(startup_pulses) Response_t SettingsManagerPwrPulseOnStartup(const uint8_t enable)
+{
+	return enable
+		       ? SetBootFlag(PWR_PULSE_ENABLED, 1, PwrPulseOnStartupEnableOk)
+		       : SetBootFlag(PWR_PULSE_ENABLED, 0, PwrPulseOnStartupDisableOk);
 }
+#endif
 
 uint8_t SettingsManagerRestoreFactory(void)
 {
@@ -112,5 +123,15 @@ uint8_t SettingsManagerRestoreFactory(void)
 
 uint8_t SettingsManagerGetBootSettings(void)
 {
-	return eeprom_read_byte((uint8_t *)0 + 2);
+	return eeprom_read_byte(BOOT_ADDR);
+}
+
+uint8_t SettingsManagerObtainOscCal(void)
+{
+	return eeprom_read_byte(OSCCAL_ADDR);
+}
+
+void SettingsManagerSaveOscCal(uint8_t value)
+{
+	eeprom_update_byte(OSCCAL_ADDR, value);
 }
@@ -18,6 +18,7 @@
 #pragma once
 #include <stdint-gcc.h>
 #include "Common.h"
+#include "Features.h"
 
 #define SETTINGS_DEFAULT_0            ((uint8_t)0x1C)
 #define SETTINGS_DEFAULT_1            ((uint8_t)0x44)
@@ -30,6 +31,9 @@
 #define RST_PULSE_ENABLED             ((uint8_t)(1U << 3U))
 #define PWR_PULSE_ENABLED             ((uint8_t)(1U << 4U))
 
+// Erased EEPROM, calibration was never cached
+#define OSCCAL_NOT_CACHED             ((uint8_t)0xFF)
+
 /**
  * \brief Save user HWDG settings into NVRAM.
  * \param status Status to be saved.
@@ -55,6 +59,22 @@ Response_t SettingsManagerApplyUserSettingsAtStartup(void);
  */
 Response_t SettingsManagerLoadDefaultSettingsAtStartup(void);
 
+#if FEATURE_STARTUP_PULSES
+/**
+ * \brief Enable or disable reset button pulse at startup.
+ * \param enable Non-zero enables the pulse.
+ * \return Returns operation status.
+ */
+Response_t SettingsManagerRstPulseOnStartup(uint8_t enable);
+
+/**
+ * \brief Enable or disable power button pulse at startup.
+ * \param enable Non-zero enables the pulse.
+ * \return Returns operation status.
+ */
+Response_t SettingsManagerPwrPulseOnStartup(uint8_t enable);
+#endif
+
 /**
  * \brief Restore factory settings.
  * \return Returns operation statuss.
@@ -65,3 +85,15 @@ uint8_t SettingsManagerRestoreFactory(void);
  * \brief Get boot settings.
  */
 uint8_t SettingsManagerGetBootSettings(void);
+
+/**
+ * \brief Get cached oscillator calibration.
+ * \return Returns OSCCAL value, OSCCAL_NOT_CACHED if none saved yet.
+ */
+uint8_t SettingsManagerObtainOscCal(void);
+
+/**
+ * \brief Cache oscillator calibration, EEPROM is written only on change.
+ * \param value OSCCAL value to be saved.
+ */
+void SettingsManagerSaveOscCal(uint8_t value);
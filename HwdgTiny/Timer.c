@@ -17,15 +17,62 @@
 
 #include "Timer.h"
 #include <avr/interrupt.h>
+#include "PowerManager.h"
+#include "Features.h"
 
 extern void RebooterTimebase(void);
 extern void LedControlerTimebase(void);
 extern void ResetControllerTimebase(void);
+extern void BootManagerTimebase(void);
 
+static volatile uint8_t pendingTicks;
+static uint8_t worstTick;
 
-ISR(TIM0_COMPA_vect)
+// Interrupts stay enabled, V-USB interrupt must start within a few cycles
+ISR(TIM0_COMPA_vect, ISR_NOBLOCK)
 {
-	RebooterTimebase();
-	LedControlerTimebase();
-	ResetControllerTimebase();
+	pendingTicks++;
+	PowerManagerSampleActivity();
+}
+
+void TimerAddTicks(uint8_t ticks)
+{
+	uint8_t sreg = SREG;
+	cli();
+	pendingTicks += ticks;
+	SREG = sreg;
+}
+
+void TimerProcessTicks(void)
+{
+	while (pendingTicks)
+	{
+		uint8_t sreg = SREG;
+		cli();
+		pendingTicks--;
+		SREG = sreg;
+
+#if TIMER_PROFILE
+		// TIM1 restarts for every tick, overflow flag tells a tick that
+		// took longer than 8 bits can hold from a short one
+		TCNT1 = 0;
+		TIFR = 1 << TOV1;
+#endif
+		RebooterTimebase();
+		LedControlerTimebase();
+		ResetControllerTimebase();
+#if FEATURE_STARTUP_PULSES
+		BootManagerTimebase();
+#endif
+#if TIMER_PROFILE
+		const uint8_t elapsed = TIFR & 1 << TOV1 ? 0xFF : TCNT1;
+		if (elapsed > worstTick)
+			worstTick = elapsed;
+#endif
+	}
+}
+
+uint8_t TimerGetWorstTick(void)
+{
+	return worstTick;
 }
@@ -20,6 +20,11 @@
 #include <stdint-gcc.h>
 #include <avr/io.h>
 
+#ifndef TIMER_PROFILE
+// Measure the longest tick with TIM1, costs a few bytes of flash
+#define TIMER_PROFILE 1
+#endif
+
 /**
 * \brief Configure TIM0 as 1ms interrupt source.
 */
@@ -37,4 +42,27 @@ __inline void TimerInit(void)
 	TCCR0B = 1 << CS02;
 	// Enable Output Compare Match interrupt.
 	TIMSK |= 1 << OCIE0A;
+#if TIMER_PROFILE
+	// TIM1 with 16 prescaler, about 1 us per count, restarted for every tick.
+	TCCR1 = 1 << CS12 | 1 << CS10;
+#endif
 }
+
+/**
+ * \brief Run timebase of every FSM once per elapsed tick. Must be called
+ * from the main loop, timer interrupt only counts ticks so it never
+ * delays V-USB interrupt.
+ */
+void TimerProcessTicks(void);
+
+/**
+ * \brief Account ticks elapsed while TIM0 was stopped.
+ * \param ticks Elapsed ticks count.
+ */
+void TimerAddTicks(uint8_t ticks);
+
+/**
+ * \brief Get the longest tick processing time seen since startup.
+ * \return Returns duration in TIM1 counts (about 1 us), 0xFF if longer.
+ */
+uint8_t TimerGetWorstTick(void);
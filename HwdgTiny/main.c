@@ -18,6 +18,7 @@
 #include "usbDriver.h"
 #include "HardwareInit.h"
 #include "SettingsManager.h"
+#include "PowerManager.h"
 
 Status_t HwdgStatus;
 
@@ -33,5 +34,6 @@ int main(void)
 	for (;;)
 	{
 		UsbPoll();
+		PowerManagerSleep();
 	}
 }
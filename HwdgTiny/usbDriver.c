@@ -23,10 +23,59 @@
 #include <util/delay.h>
 #include "LedController.h"
 #include "ResetController.h"
+#include "Common.h"
+#include "SettingsManager.h"
+#include <avr/interrupt.h>
 
 
-#define abs(x) ((x) > 0 ? (x) : (-x))
+#ifndef USB_NOTIFY_QUEUE_SIZE
+// Reports awaiting interrupt-IN endpoint, must be power of two
+#define USB_NOTIFY_QUEUE_SIZE   4
+#endif
+
+// Interrupt-IN report length: report ID and 5 data bytes
+#define USB_REPORT_LENGTH       6
+
+// Single command report ID
+#define REPORT_COMMAND          1
+// Command batch report ID
+#define REPORT_BATCH            2
+// Command batch report length: report ID and up to 7 commands,
+// fits in one V-USB chunk so no USB_CFG_LONG_TRANSFERS needed
+#define USB_BATCH_LENGTH        8
+// Diagnostics report ID
+#define REPORT_DIAGNOSTICS      3
+// Diagnostics report length: report ID, worst tick and retries count
+#define USB_DIAGNOSTICS_LENGTH  4
+// Tagged command result report ID, pushed through interrupt-IN endpoint
+#define REPORT_RESULT           4
+// Tagged command result report length: report ID, tag and result
+#define USB_RESULT_LENGTH       3
+
+#ifndef OSCCAL_REFINE_RANGE
+// OSCCAL steps tried on each side of the cached value
+#define OSCCAL_REFINE_RANGE     2
+#endif
+
+#ifndef OSCCAL_MAX_DEVIATION
+// Frame length deviation the cached value may have, about 1% of
+// the target, above it the full binary search runs
+#define OSCCAL_MAX_DEVIATION    24
+#endif
+
+#define abs(x) ((x) > 0 ? (x) : -(x))
 static uint8_t bytesRemaining;
+static uint8_t reportId;
+static uint8_t batchIndex;
+static uint8_t batchReport[USB_BATCH_LENGTH];
+static uint8_t resultReport[USB_RESULT_LENGTH];
+static uint8_t resultPending;
+static uint16_t retries;
+static volatile uint8_t notifyQueue[USB_NOTIFY_QUEUE_SIZE];
+static volatile uint8_t notifyHead;
+static volatile uint8_t notifyTail;
+
+extern Status_t HwdgStatus;
 
 /**
  * \brief Device descriptor.
@@ -42,66 +91,107 @@ PROGMEM const char usbHidReportDescriptor[USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH]
 	0x75, 0x08, //   REPORT_SIZE (8)
 	0x95, 0x01, //   REPORT_COUNT (1)
 	0xb1, 0x82, //   FEATURE (Data,Var,Abs,Vol)
+	0x95, 0x02, //   REPORT_COUNT (2)
+	0x09, 0x01, //   USAGE (Vendor Usage 1)
+	0x91, 0x82, //   OUTPUT (Data,Var,Abs,Vol)
+	0x75, 0x08, //   REPORT_SIZE (8)
+	0x95, 0x05, //   REPORT_COUNT (5)
 	0x09, 0x01, //   USAGE (Vendor Usage 1)
-	0x91, 0x82, //   INPUT (Data,Var,Abs,Vol)
+	0x81, 0x82, //   INPUT (Data,Var,Abs,Vol)
+	0x85, 0x02, //   REPORT_ID (2)
 	0x75, 0x08, //   REPORT_SIZE (8)
-	0x95, 0x05, //   REPORT_COUNT (4)
+	0x95, 0x07, //   REPORT_COUNT (7)
+	0x09, 0x01, //   USAGE (Vendor Usage 1)
+	0x91, 0x82, //   OUTPUT (Data,Var,Abs,Vol)
+	0x09, 0x01, //   USAGE (Vendor Usage 1)
+	0x81, 0x82, //   INPUT (Data,Var,Abs,Vol)
+	0x85, 0x03, //   REPORT_ID (3)
+	0x95, 0x03, //   REPORT_COUNT (3)
+	0x09, 0x01, //   USAGE (Vendor Usage 1)
+	0x81, 0x82, //   INPUT (Data,Var,Abs,Vol)
+	0x85, 0x04, //   REPORT_ID (4)
+	0x95, 0x02, //   REPORT_COUNT (2)
 	0x09, 0x01, //   USAGE (Vendor Usage 1)
 	0x81, 0x82, //   INPUT (Data,Var,Abs,Vol)
 	0xc0 // END_COLLECTION
 };
 
+/**
+ * \brief Measure how far USB frame length is from the expected one.
+ * \param cal OSCCAL value to be tried.
+ * \return Returns absolute deviation in usbMeasureFrameLength units.
+ */
+static int MeasureDeviation(uint8_t cal)
+{
+	const int targetLength = (unsigned)(1499 * (double)F_CPU / 10.5e6 + 0.5);
+	OSCCAL = cal;
+	const int frameLength = usbMeasureFrameLength();
+	return abs(frameLength - targetLength);
+}
+
 /**
  * \brief Called by V-USB after device reset
  */
 void hadUsbReset()
 {
-	int targetLength = (unsigned)(1499 * (double)F_CPU / 10.5e6 + 0.5);
 	int bestDeviation = 9999;
-	uint8_t bestCal = 0;
+	uint8_t bestCal = OSCCAL;
 
-	// do a binary search in regions 0-127 and 128-255 to get optimum OSCCAL
-	for (uint8_t region = 0; region <= 1; region++)
+	// Cached value only needs a short walk around it, OSCCAL has two
+	// overlapping ranges so the walk never leaves the cached one
+	const uint8_t cached = SettingsManagerObtainOscCal();
+	if (cached != OSCCAL_NOT_CACHED)
 	{
-		int frameLength = 0;
-		uint8_t trialCal = region == 0 ? 0 : 128;
+		const uint8_t low = (cached & 0x7F) < OSCCAL_REFINE_RANGE
+			                    ? cached & 0x80
+			                    : cached - OSCCAL_REFINE_RANGE;
+		const uint8_t high = (cached & 0x7F) > 0x7F - OSCCAL_REFINE_RANGE
+			                     ? cached | 0x7F
+			                     : cached + OSCCAL_REFINE_RANGE;
 
-		for (uint8_t step = 64; step > 0; step >>= 1)
+		for (uint8_t trialCal = low; ; trialCal++)
 		{
-			if (frameLength < targetLength) // true for initial iteration
-				trialCal += step; // frequency too low
-			else
-				trialCal -= step; // frequency too high
-
-			OSCCAL = trialCal;
+			const int deviation = MeasureDeviation(trialCal);
+			if (deviation < bestDeviation)
+			{
+				bestCal = trialCal; // new optimum found
+				bestDeviation = deviation;
+			}
+			if (trialCal == high) break;
+		}
+	}
 
-			frameLength = usbMeasureFrameLength();
+	// No cache or it went too far off, do a binary search
+	// in regions 0-127 and 128-255 to get optimum OSCCAL
+	if (bestDeviation > OSCCAL_MAX_DEVIATION)
+	{
+		const int targetLength = (unsigned)(1499 * (double)F_CPU / 10.5e6 + 0.5);
+		for (uint8_t region = 0; region <= 1; region++)
+		{
+			int frameLength = 0;
+			uint8_t trialCal = region == 0 ? 0 : 128;
 
-			if (abs(frameLength - targetLength) < bestDeviation)
+			for (uint8_t step = 64; step > 0; step >>= 1)
 			{
-				bestCal = trialCal; // new optimum found
-				bestDeviation = abs(frameLength - targetLength);
+				if (frameLength < targetLength) // true for initial iteration
+					trialCal += step; // frequency too low
+				else
+					trialCal -= step; // frequency too high
+
+				OSCCAL = trialCal;
+
+				frameLength = usbMeasureFrameLength();
+
+				if (abs(frameLength - targetLength) < bestDeviation)
+				{
+					bestCal = trialCal; // new optimum found
+					bestDeviation = abs(frameLength - targetLength);
+				}
 			}
 		}
 	}
 	OSCCAL = bestCal;
-}
-
-/**
- * \brief This function is called by the driver to ask the application for a
- * control transfer's payload data (control-in). It is called in chunks of up
- * to 8 bytes each.You should copy the data to the location given by 'data'
- * and return the actual number of bytes copied.If you return less than
- * requested, the control - in transfer is terminated.
- * \param data Outcoming data pointer.
- * \param len Outcoming data length.
- * \return Returns remaining data length.
- */
-uint8_t usbFunctionRead(uint8_t* data, uint8_t len)
-{
-	if (len > bytesRemaining)
-		len = bytesRemaining;
-	return len;
+	SettingsManagerSaveOscCal(bestCal);
 }
 
 /**
@@ -122,14 +212,42 @@ uint8_t usbFunctionWrite(uint8_t* data, uint8_t len)
 		len = bytesRemaining;
 	bytesRemaining -= len;
 
-	if (bytesRemaining == 0)
-		OnCommandReceived(data[1]);
+	for (uint8_t i = 0; i < len; i++)
+	{
+		// First byte of the transfer is the report ID
+		if (reportId == 0)
+		{
+			reportId = data[i];
+			continue;
+		}
+		// Single command report carries one command followed by its
+		// tag, zero tag asks for no pushed result. Both reports may be
+		// padded with zeros by the host.
+		if (reportId != REPORT_BATCH && batchIndex > 1)
+		{
+			if (resultReport[1] == 0x00)
+				resultReport[1] = data[i];
+			continue;
+		}
+		if (reportId == REPORT_BATCH && data[i] == 0x00)
+			continue;
+
+		OnCommandReceived(data[i]);
+		if (batchIndex < USB_BATCH_LENGTH)
+			batchReport[batchIndex++] = HwdgStatus.LastCommandStatus;
+	}
+
+	// Tagged result is pushed through interrupt-IN endpoint, so the
+	// host needs no GET_REPORT. Late one is told apart by its tag.
+	if (bytesRemaining == 0 && reportId != REPORT_BATCH && resultReport[1] != 0x00)
+	{
+		resultReport[2] = HwdgStatus.LastCommandStatus;
+		resultPending = 1;
+	}
 
 	return bytesRemaining == 0;
 }
 
-extern Status_t HwdgStatus;
-
 /**
  * \brief This function is called when the driver receives a SETUP transaction
  * from the host which is not answered by the driver itself(in practice : class
@@ -147,14 +265,49 @@ usbMsgLen_t usbFunctionSetup(uint8_t data[8])
 
 	if ((rq->bmRequestType & USBRQ_TYPE_MASK) == USBRQ_TYPE_CLASS)
 	{
+		// New request while SET_REPORT data is still awaited means
+		// the host gave up on a lost packet and retries the transfer
+		if (bytesRemaining != 0)
+		{
+			bytesRemaining = 0;
+			if (retries != UINT16_MAX)
+				retries++;
+		}
+
 		if (rq->bRequest == USBRQ_HID_GET_REPORT)
 		{
-			usbMsgPtr = (uint16_t)&HwdgStatus;
+			if (rq->wValue.bytes[0] == REPORT_DIAGNOSTICS)
+			{
+				static uint8_t report[USB_DIAGNOSTICS_LENGTH];
+				report[0] = REPORT_DIAGNOSTICS;
+				report[1] = TimerGetWorstTick();
+				report[2] = (uint8_t)retries;
+				report[3] = (uint8_t)(retries >> 8);
+				usbMsgPtr = (usbMsgPtr_t)report;
+				return USB_DIAGNOSTICS_LENGTH;
+			}
+			if (rq->wValue.bytes[0] == REPORT_BATCH)
+			{
+				usbMsgPtr = (usbMsgPtr_t)batchReport;
+				return USB_BATCH_LENGTH;
+			}
+			usbMsgPtr = (usbMsgPtr_t)&HwdgStatus;
 			return 6;
 		}
 		if (rq->bRequest == USBRQ_HID_SET_REPORT)
 		{
-			bytesRemaining = 2;
+			// Command results of a batch are collected into batch report,
+			// one result per command in the order they were received
+			reportId = 0;
+			batchIndex = 1;
+			batchReport[0] = REPORT_BATCH;
+			for (uint8_t i = 1; i < USB_BATCH_LENGTH; i++)
+				batchReport[i] = 0x00;
+			resultReport[0] = REPORT_RESULT;
+			resultReport[1] = 0x00;
+			bytesRemaining = rq->wLength.word > USB_BATCH_LENGTH
+				                 ? USB_BATCH_LENGTH
+				                 : rq->wLength.word;
 			return USB_NO_MSG;
 		}
 	}
@@ -166,3 +319,35 @@ __attribute__((weak)) void OnCommandReceived(uint8_t data)
 	for (;;)
 		;
 }
+
+void UsbNotify(uint8_t code)
+{
+	uint8_t sreg = SREG;
+	cli();
+	// Drop the report when host does not poll, the oldest ones are kept
+	if ((uint8_t)(notifyHead - notifyTail) < USB_NOTIFY_QUEUE_SIZE)
+		notifyQueue[notifyHead++ & (USB_NOTIFY_QUEUE_SIZE - 1)] = code;
+	SREG = sreg;
+}
+
+void UsbSendPending(void)
+{
+	static uint8_t report[USB_REPORT_LENGTH];
+
+	// Command result goes first, the host waits for it
+	if (resultPending)
+	{
+		resultPending = 0;
+		usbSetInterrupt(resultReport, USB_RESULT_LENGTH);
+		return;
+	}
+
+	if (notifyHead == notifyTail) return;
+
+	// Same layout as GET_REPORT, status bytes followed by the event code
+	*(Status_t*)report = HwdgStatus;
+	report[0] = 0x01;
+	report[USB_REPORT_LENGTH - 1] = notifyQueue[notifyTail & (USB_NOTIFY_QUEUE_SIZE - 1)];
+	notifyTail++;
+	usbSetInterrupt(report, USB_REPORT_LENGTH);
+}
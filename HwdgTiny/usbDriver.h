@@ -20,11 +20,31 @@
 #include <stdint-gcc.h>
 #include "usbdrv.h"
 #include <util/delay.h>
+#include "SettingsManager.h"
+#include "Timer.h"
+
+/**
+ * \brief Queue event to be pushed to the host through the interrupt-IN
+ * endpoint. Safe to call from ISR.
+ * \param code Event code.
+ */
+void UsbNotify(uint8_t code);
+
+/**
+ * \brief Push tagged command result or the oldest queued event
+ * when interrupt-IN endpoint is free.
+ */
+void UsbSendPending(void);
+
 /**
 * \brief This routine initializes USB driver.
 */
 __inline void UsbInit(void)
 {
+	// Start with cached calibration, hadUsbReset only refines it
+	const uint8_t cal = SettingsManagerObtainOscCal();
+	if (cal != OSCCAL_NOT_CACHED)
+		OSCCAL = cal;
 	usbInit();
 	usbDeviceDisconnect();
 	_delay_ms(250);
@@ -39,6 +59,9 @@ __inline void UsbInit(void)
 __inline void UsbPoll(void)
 {
 	usbPoll();
+	TimerProcessTicks();
+	if (usbInterruptIsReady())
+		UsbSendPending();
 }
 
 /**
@@ -92,11 +92,12 @@ section at the end of this file).
  * Since the token is toggled BEFORE sending any data, the first packet is
  * sent with the oposite value of this configuration!
  */
-#define USB_CFG_IMPLEMENT_HALT          1
+#define USB_CFG_IMPLEMENT_HALT          0
 /* Define this to 1 if you also want to implement the ENDPOINT_HALT feature
  * for endpoint 1 (interrupt endpoint). Although you may not need this feature,
  * it is required by the standard. We have made it a config option because it
- * bloats the code considerably.
+ * bloats the code considerably. HID class drivers never halt the interrupt
+ * endpoint, so the flash goes to watchdog features instead.
  */
 #define USB_CFG_SUPPRESS_INTR_CODE      0
 /* Define this to 1 if you want to declare interrupt-in endpoints, but don't
@@ -106,10 +107,13 @@ section at the end of this file).
  * (e.g. HID), but never want to send any data. This option saves a couple
  * of bytes in flash memory and the transmit buffers in RAM.
  */
-#define USB_CFG_INTR_POLL_INTERVAL      100
+#ifndef USB_CFG_INTR_POLL_INTERVAL
+#define USB_CFG_INTR_POLL_INTERVAL      10
+#endif
 /* If you compile a version with endpoint 1 (interrupt-in), this is the poll
  * interval. The value is in milliseconds and must not be less than 10 ms for
- * low speed devices.
+ * low speed devices. Responses and events are pushed through this endpoint,
+ * so it bounds command latency. Override it from the build to save bus time.
  */
 #define USB_CFG_IS_SELF_POWERED         0
 /* Define this to 1 if the device has its own power supply. Set it to 0 if the
@@ -280,7 +284,7 @@ extern void hadUsbReset(void);  // define the function for usbdrv.c
  * HID class is 3, no subclass and protocol required (but may be useful!)
  * CDC class is 2, use subclass 2 and protocol 1 for ACM
  */
-#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH   35
+#define USB_CFG_HID_REPORT_DESCRIPTOR_LENGTH   67
 /* Define this to the length of the HID report descriptor, if you implement
  * an HID device. Otherwise don't define it or define it to 0.
  * If you use this define, you must add a PROGMEM character array named
@@ -357,12 +361,15 @@ extern void hadUsbReset(void);  // define the function for usbdrv.c
 #define USB_CFG_DESCR_PROPS_UNKNOWN                 0
 
 
+#ifndef usbMsgPtr_t
 #define usbMsgPtr_t unsigned short
+#endif
 /* If usbMsgPtr_t is not defined, it defaults to 'uchar *'. We define it to
  * a scalar type here because gcc generates slightly shorter code for scalar
  * arithmetics than for pointer arithmetics. Remove this define for backward
  * type compatibility or define it to an 8 bit type if you use data in RAM only
  * and all RAM is below 256 bytes (tiny memory model in IAR CC).
+ * Host builds of the firmware sources define it to a pointer sized type.
  */
 
 /* ----------------------- Optional MCU Description ------------------------ */
@@ -16,6 +16,7 @@
 // along with HwdgWrapper. If not, see <http://www.gnu.org/licenses/>.
 
 using System;
+using System.Collections.Generic;
 using System.Linq;
 using System.Threading;
 using System.Threading.Tasks;
@@ -25,7 +26,16 @@ namespace HwdgWrapper
 {
     public class HidWrapper:IWrapper
     {
+        private const Byte CommandReportId = 1;
+        private const Byte BatchReportId = 2;
+        private const Int32 BatchSize = 7;
+        private const Int32 ResponseIndex = 4;
+        private const Byte ResultReportId = 4;
+        private const Int32 ResultTimeout = 100;
         private readonly IHidDevice device;
+        private readonly Queue<Response> events = new Queue<Response>();
+        private Byte nextTag = 1;
+        private Boolean? pushesResults;
         public HidWrapper(IHidDevice device)
         {
             this.device = device;
@@ -41,15 +51,105 @@ namespace HwdgWrapper
 
         public Response SendCommand(Byte cmd)
         {
-            var report = new Report
+            // Tag needs the second byte of output report, firmware older
+            // than batch report has no room for it and never pushes results
+            if (pushesResults == null && device.Info.Capabilities.OutputReportByteLength <= 2)
+                pushesResults = false;
+
+            if (pushesResults == false)
+            {
+                device.SendReport(CreateReport(CommandReportId, new[] {cmd}));
+                return ReadResult();
+            }
+
+            // Device pushes tagged result through interrupt-IN endpoint, result
+            // of a command that timed out earlier carries another tag and is dropped.
+            var tag = nextTag;
+            nextTag = (Byte) (nextTag == Byte.MaxValue ? 1 : nextTag + 1);
+            device.SendReport(CreateReport(CommandReportId, new[] {cmd, tag}));
+
+            Report report;
+            while ((report = device.ReadReport(ResultTimeout)) != null)
             {
-                ReportId = 1,
-                Data = new[] {cmd}
-            };
+                if (report.ReportId != ResultReportId)
+                {
+                    QueueEvent(report);
+                    continue;
+                }
+                if (report.Data.First() != tag) continue;
+
+                pushesResults = true;
+                return (Response) report.Data.ElementAt(1);
+            }
+
+            // Firmware that never pushed a result doesn't do it at all,
+            // it pays the timeout once and is polled from now on
+            if (pushesResults == null) pushesResults = false;
+            return ReadResult();
+        }
+
+        private Response ReadResult()
+        {
+            var result = device.GetReport(CommandReportId);
+            return (Response) result.Data.ElementAt(ResponseIndex);
+        }
+
+        private void QueueEvent(Report report)
+        {
+            if (report.ReportId != CommandReportId) return;
+            var response = (Response) report.Data.ElementAt(ResponseIndex);
+            if (IsEvent(response)) events.Enqueue(response);
+        }
 
-            device.SendReport(report);
-            var result = device.GetReport(1);
-            return (Response) result.Data.Last();
+        /// <summary>
+        /// Read next event hwdg pushed through its interrupt-IN endpoint.
+        /// </summary>
+        /// <param name="timeout">Read timeout in milliseconds.</param>
+        /// <returns>Returns event if one arrived within <paramref name="timeout"/>, otherwise returns null.</returns>
+        public Response? ReadEvent(Int32 timeout)
+        {
+            // Events read while waiting for command result come first,
+            // late command results are dropped
+            Report report;
+            while (events.Count == 0 && (report = device.ReadReport(timeout)) != null)
+                QueueEvent(report);
+            return events.Count != 0 ? events.Dequeue() : (Response?) null;
+        }
+
+        /// <summary>
+        /// Send several commands to hwdg, up to seven of them in one transfer.
+        /// </summary>
+        /// <param name="cmds">Commands to be sent.</param>
+        /// <returns>Returns hwdg responses in the same order as <paramref name="cmds"/>.</returns>
+        public Response[] SendCommands(Byte[] cmds)
+        {
+            // Firmware without batch report takes commands one by one
+            if (device.Info.Capabilities.OutputReportByteLength <= BatchSize)
+                return cmds.Select(SendCommand).ToArray();
+
+            var result = new List<Response>(cmds.Length);
+            for (var i = 0; i < cmds.Length; i += BatchSize)
+            {
+                var batch = cmds.Skip(i).Take(BatchSize).ToArray();
+                device.SendReport(CreateReport(BatchReportId, batch));
+                var report = device.GetReport(BatchReportId);
+                result.AddRange(report.Data.Take(batch.Length).Select(x => (Response) x));
+            }
+            return result.ToArray();
+        }
+
+        private Report CreateReport(Byte reportId, Byte[] cmds)
+        {
+            // Every report is padded up to the longest output report,
+            // zero bytes are skipped by the device
+            var data = new Byte[device.Info.Capabilities.OutputReportByteLength - 1];
+            Array.Copy(cmds, data, cmds.Length);
+            return new Report {ReportId = reportId, Data = data};
+        }
+
+        private static Boolean IsEvent(Response response)
+        {
+            return response >= Response.FirstResetOccurred && response <= Response.WatchdogOk;
         }
 
         public Task<Status> GetStatusAsync(CancellationToken ct = default(CancellationToken))
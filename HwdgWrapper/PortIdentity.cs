@@ -0,0 +1,92 @@
+﻿// Copyright 2017 Oleg Petrochenko
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.IO.Ports;
+using System.Linq;
+using System.Runtime.InteropServices;
+
+namespace HwdgWrapper
+{
+    /// <summary>
+    /// Stable name of a serial port that survives replugging and renumbering.
+    /// </summary>
+    internal static class PortIdentity
+    {
+        /// <summary>
+        /// Udev links named by USB serial number, then by USB topology path.
+        /// </summary>
+        private static readonly String[] LinkDirectories = {"/dev/serial/by-id", "/dev/serial/by-path"};
+
+        private static Boolean IsUnix => Environment.OSVersion.Platform == PlatformID.Unix;
+
+        /// <summary>
+        /// Gets a name which identifies the device behind the port rather than the port itself.
+        /// On Linux it is the udev link to the port, on Windows COM names are already bound
+        /// to the device instance so the port name itself is returned.
+        /// </summary>
+        /// <param name="portName">Port name as reported by SerialPort.GetPortNames.</param>
+        /// <returns>Returns a name that can be opened as a serial port.</returns>
+        public static String Get(String portName)
+        {
+            if (!IsUnix) return portName;
+            try
+            {
+                var device = RealPath(portName);
+                if (device == null) return portName;
+                foreach (var directory in LinkDirectories.Where(Directory.Exists))
+                {
+                    var link = Directory.GetFiles(directory).FirstOrDefault(l => RealPath(l) == device);
+                    if (link != null) return link;
+                }
+            }
+            catch (Exception ex)
+            {
+                Trace.WriteLine($"Unable to identify {portName} port. Reason: {ex.Message}");
+            }
+            return portName;
+        }
+
+        /// <summary>
+        /// Checks the device identified by the name is present now.
+        /// </summary>
+        /// <param name="identity">Name returned by Get.</param>
+        public static Boolean Exists(String identity)
+        {
+            return IsUnix ? File.Exists(identity) : SerialPort.GetPortNames().Contains(identity);
+        }
+
+        private static String RealPath(String path)
+        {
+            var resolved = realpath(path, IntPtr.Zero);
+            if (resolved == IntPtr.Zero) return null;
+            try
+            {
+                return Marshal.PtrToStringAnsi(resolved);
+            }
+            finally
+            {
+                free(resolved);
+            }
+        }
+
+        [DllImport("libc", CharSet = CharSet.Ansi)]
+        private static extern IntPtr realpath(String path, IntPtr resolved);
+
+        [DllImport("libc")]
+        private static extern void free(IntPtr ptr);
+    }
+}
\ No newline at end of file
@@ -54,6 +54,12 @@ namespace HwdgWrapper
 
         SaveSettingsError = 0x47,
         PowerPulseOk = 0x48,
+        SetEscalationStageOk = 0x49,
+        EnableAutoRearmOk = 0x4A,
+        DisableAutoRearmOk = 0x4B,
+        SetAdaptiveRebootOk = 0x4C,
+        SetActivityTimeoutOk = 0x4D,
+        SetEventStreamOk = 0x4E,
 
         UnknownCommand = 0x4F,
 
@@ -63,6 +69,9 @@ namespace HwdgWrapper
         MovedToIdle = 0x33,
         WatchdogOk = 0x34,
         SoftwareVersion = 0x55,
+        TaggedResponse = 0x56,
+        SetBusAddressOk = 0x57,
+        InvalidArgument = 0x58,
 
         SendCommandNoHwdgResponse = 0x60,
         SendCommandUnknownError = 0x61,
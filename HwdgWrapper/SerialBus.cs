@@ -0,0 +1,165 @@
+﻿// Copyright 2017 Oleg Petrochenko
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO.Ports;
+using System.Linq;
+using System.Threading;
+
+namespace HwdgWrapper
+{
+    /// <summary>
+    /// Talks to several HWDG boards sharing one half-duplex line in bus mode
+    /// (board address set with SetBusAddress command).
+    /// </summary>
+    /// <remarks>
+    /// Every command goes in [0xA6][address][length][payload] frame. Boards resync on idle
+    /// line, so the line is kept idle for BusIdleGap before every frame.
+    /// </remarks>
+    public class SerialBus : IDisposable
+    {
+        private const Int32 Baudrate = 9600;
+        private const Byte FrameMarker = 0xA6;
+        private const Byte BroadcastAddress = 0xFF;
+        private const Byte GetStatusCommand = 0x01;
+        private const Int32 StatusLength = 5;
+        private const Int32 ReadResponseTimeout = 80;
+
+        /// <summary>
+        /// Idle line time before every frame, ms. Longer than one byte at 9600 baud
+        /// (STM8 idle line detection) and the 3 ms gap Arduino boards wait for.
+        /// </summary>
+        public const Int32 BusIdleGap = 5;
+
+        private readonly Object threadLock = new Object();
+        private readonly SerialPort port;
+        private readonly Stopwatch idle = Stopwatch.StartNew();
+
+        public SerialBus(String portName)
+        {
+            port = new SerialPort(portName, Baudrate)
+            {
+                ReadTimeout = ReadResponseTimeout,
+                WriteTimeout = ReadResponseTimeout
+            };
+            port.Open();
+        }
+
+        /// <summary>
+        /// Send command to the board.
+        /// </summary>
+        /// <param name="address">Board address (1-254).</param>
+        /// <param name="command">Command followed by its arguments.</param>
+        /// <returns>Returns hwdg command response.</returns>
+        public Response SendCommand(Byte address, params Byte[] command)
+        {
+            CheckAddress(address);
+            lock (threadLock)
+            {
+                var rsp = new Byte[1];
+                return Transfer(address, command, rsp) ? (Response) rsp[0] : Response.SendCommandNoHwdgResponse;
+            }
+        }
+
+        /// <summary>
+        /// Send command to all boards at once. Boards don't respond to broadcast.
+        /// </summary>
+        /// <param name="command">Command followed by its arguments.</param>
+        public void Broadcast(params Byte[] command)
+        {
+            lock (threadLock) Transfer(BroadcastAddress, command, null);
+        }
+
+        /// <summary>
+        /// Gets status of the board.
+        /// </summary>
+        /// <param name="address">Board address (1-254).</param>
+        /// <returns>Returns hwdg status or null if the board doesn't respond.</returns>
+        public Status GetStatus(Byte address)
+        {
+            CheckAddress(address);
+            lock (threadLock)
+            {
+                var b = new Byte[StatusLength];
+                if (!Transfer(address, new[] {GetStatusCommand}, b)) return null;
+                if (b.CalcCrc7(StatusLength - 1) == b[StatusLength - 1]) return new Status(b);
+                Trace.WriteLine($"Checksum verification error from {address} board");
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Gets status of the boards one after another.
+        /// </summary>
+        /// <param name="addresses">Board addresses (1-254).</param>
+        /// <returns>Returns status of every board responded.</returns>
+        public IDictionary<Byte, Status> Poll(IEnumerable<Byte> addresses)
+        {
+            return addresses
+                .Distinct()
+                .Select(a => new {Address = a, Status = GetStatus(a)})
+                .Where(r => r.Status != null)
+                .ToDictionary(r => r.Address, r => r.Status);
+        }
+
+        private static void CheckAddress(Byte address)
+        {
+            if (address == 0 || address == BroadcastAddress)
+                throw new ArgumentOutOfRangeException(nameof(address));
+        }
+
+        private Boolean Transfer(Byte address, Byte[] payload, Byte[] response)
+        {
+            if (payload == null) throw new ArgumentNullException(nameof(payload));
+            if (payload.Length == 0 || payload.Length > Byte.MaxValue)
+                throw new ArgumentOutOfRangeException(nameof(payload));
+
+            // Late response of the board asked last time would be taken as
+            // this board response, idle gap lets it arrive and be dropped.
+            var wait = BusIdleGap - (Int32) idle.ElapsedMilliseconds;
+            if (wait > 0) Thread.Sleep(wait);
+            port.DiscardInBuffer();
+
+            var frame = new Byte[payload.Length + 3];
+            frame[0] = FrameMarker;
+            frame[1] = address;
+            frame[2] = (Byte) payload.Length;
+            Array.Copy(payload, 0, frame, 3, payload.Length);
+            try
+            {
+                port.Write(frame, 0, frame.Length);
+                if (response == null) return true;
+                for (var i = 0; i < response.Length; i++)
+                    response[i] = (Byte) port.ReadByte();
+                return true;
+            }
+            catch (TimeoutException)
+            {
+                Trace.WriteLine($"No response from {address} board");
+                return false;
+            }
+            finally
+            {
+                idle.Restart();
+            }
+        }
+
+        public void Dispose()
+        {
+            port.Dispose();
+        }
+    }
+}
\ No newline at end of file
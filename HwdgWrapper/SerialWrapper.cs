@@ -13,8 +13,10 @@
 // limitations under the License.
 
 using System;
+using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO.Ports;
+using System.Linq;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -23,9 +25,26 @@ namespace HwdgWrapper
     public class SerialWrapper : IWrapper, IDisposable
     {
         private const Int32 Baudrate = 9600;
+        private const Int32 DefaultWindow = 4;
+        private const Int32 ReadStatusTimeout = 80;
+        private const Int32 StatusLength = 5;
+        private const Byte GetStatusCommand = 0x01;
+
+        /// <summary>
+        /// Commands SendCommands can't pipeline: the ones followed by arguments,
+        /// the ones with multibyte response and the ones with no response at all.
+        /// </summary>
+        private static readonly HashSet<Byte> NotPipelinedCommands = new HashSet<Byte>
+        {
+            0x04, 0x08, 0x0A, 0x0B, 0x0D, 0x0E, // Commands with arguments
+            0x01, 0x05, 0x09, 0x0C, 0x0F, // Commands with multibyte response
+            0x00, 0xF7 // ChipReset and RestoreFactory
+        };
         private readonly Object threadLock = new Object();
         private readonly Timer timer;
         private String lastSuccessedPortName;
+        private String lastPortIdentity;
+        private Boolean searchPortBusy;
         private Boolean isUpdated;
         private Status lastStatus;
 
@@ -143,6 +162,48 @@ namespace HwdgWrapper
             }
         }
 
+        /// <summary>
+        /// Send several commands keeping up to window commands in flight.
+        /// </summary>
+        /// <param name="cmds">Commands with single byte response to be sent.</param>
+        /// <param name="window">Greatest count of commands sent but not responded yet.</param>
+        /// <returns>Returns hwdg response for each command.</returns>
+        /// <exception cref="ArgumentException">Thrown if a command has arguments or other than single byte response.</exception>
+        public Response[] SendCommands(Byte[] cmds, Int32 window = DefaultWindow)
+        {
+            if (cmds == null) throw new ArgumentNullException(nameof(cmds));
+            var invalid = cmds.Where(NotPipelinedCommands.Contains).ToArray();
+            if (invalid.Length > 0)
+                throw new ArgumentException($"Commands {String.Join(", ", invalid.Select(c => $"0x{c:X2}"))} can't be pipelined.", nameof(cmds));
+
+            // We're working with single resource (Serial port) so we
+            // must use one SerialPort instance at the moment.
+            lock (threadLock)
+            {
+                Trace.WriteLine($"Enter SendCommands at {Thread.CurrentThread.ManagedThreadId} thread");
+                if (lastSuccessedPortName == null) SearchAndGetStatus();
+
+                var result = new Response[cmds.Length];
+                for (var i = 0; i < result.Length; i++) result[i] = Response.SendCommandNoHwdgResponse;
+                if (lastSuccessedPortName != null)
+                    SendCommands(lastSuccessedPortName, cmds, Math.Max(1, Math.Min(window, 256)), result);
+
+                // Commands may change HWDG state, as well as connection might be lost.
+                if (isUpdated && lastSuccessedPortName == null)
+                {
+                    isUpdated = false;
+                    OnDisconnected();
+                }
+                else if (lastSuccessedPortName != null)
+                {
+                    GetStatusIsUpdatedCheck(GetStatus(lastSuccessedPortName));
+                }
+
+                Trace.WriteLine($"Exit SendCommands at {Thread.CurrentThread.ManagedThreadId} thread");
+                return result;
+            }
+        }
+
         public async Task<Status> GetStatusAsync(CancellationToken ct = default(CancellationToken))
         {
             Trace.WriteLine($"Begin get status async at {Thread.CurrentThread.ManagedThreadId} thread...");
@@ -161,127 +222,98 @@ namespace HwdgWrapper
         /// <returns></returns>
         private Status SearchAndGetStatus()
         {
-            Status result = null;
+            // In case we already know port name just get status.
+            if (lastSuccessedPortName != null) return GetStatus(lastSuccessedPortName);
+            searchPortBusy = false;
+
             // If last transmission was unsuccessful or this is a first
             // transmission we need to find serial port HWDG connected to.
-            if (lastSuccessedPortName == null)
+            // The device found last time is tried first by its identity,
+            // which stays the same when the port gets renumbered.
+            if (lastPortIdentity != null && PortIdentity.Exists(lastPortIdentity))
             {
-                Trace.WriteLine("Trying to find a port with WDG connected...");
-                foreach (var portName in SerialPort.GetPortNames())
-                {
-                    result = GetStatus(portName);
-                    if (result != null)
-                        return result;
-                }
+                Trace.WriteLine($"Trying to find WDG at {lastPortIdentity} first...");
+                var result = GetStatus(lastPortIdentity);
+                if (result != null) return result;
             }
-            // In case we already know port name just send the command.
-            else
+
+            Trace.WriteLine("Trying to find a port with WDG connected...");
+            var found = ProbePorts(SerialPort.GetPortNames(), out var busy);
+            searchPortBusy |= busy;
+            if (found == null)
             {
-                result = GetStatus(lastSuccessedPortName);
+                Trace.WriteLine($"HWDG not found on any port at {Thread.CurrentThread.ManagedThreadId} thread");
+                return null;
             }
-            return result;
+
+            lastPortIdentity = PortIdentity.Get(found.PortName);
+            Trace.WriteLine($"HWDG found at {found.PortName} identified as {lastPortIdentity}");
+            TransmissionOk(lastPortIdentity);
+            return found.Status;
+        }
+
+        /// <summary>
+        /// Gets status from all ports at once.
+        /// </summary>
+        /// <param name="portNames">Ports to be probed.</param>
+        /// <param name="busy">Set if some port is opened by another application.</param>
+        /// <returns>Returns the port which responded with valid status first or null.</returns>
+        private static ProbeResult ProbePorts(String[] portNames, out Boolean busy)
+        {
+            var probes = portNames.Select(n => Task.Run(() => ProbeStatusAsync(n, ReadStatusTimeout))).ToArray();
+            var results = Task.WhenAll(probes).GetAwaiter().GetResult();
+            busy = results.Any(r => r.IsBusy);
+
+            // Ports which returned checksum-valid status are ranked by response time,
+            // silent ports and garbage are dropped.
+            var ranked = results.Where(r => r.Status != null).OrderBy(r => r.Elapsed).ToArray();
+            foreach (var r in ranked.Skip(1))
+                Trace.WriteLine($"HWDG also responded at {r.PortName} in {r.Elapsed.TotalMilliseconds} ms");
+            return ranked.FirstOrDefault();
         }
 
         private Response SearchAndSendCommand(Byte cmd)
         {
             // If last transmission was unsuccessful or this is a first
             // transmission we need to find serial port HWDG connected to.
-            if (lastSuccessedPortName == null)
+            // Only status request is sent to unknown ports, so command
+            // never reaches device other than HWDG.
+            // HWDG may be behind a port another application holds.
+            if (lastSuccessedPortName == null && SearchAndGetStatus() == null)
             {
-                var result = Response.ErrorSendCmd;
-                Trace.WriteLine("Trying to find a port with WDG connected...");
-                foreach (var portName in SerialPort.GetPortNames())
-                {
-                    Trace.WriteLine($"Trying to sent cmd at {portName}");
-                    result = SendCommand(portName, cmd);
-                    Trace.WriteLine($"Cmd result {result}");
-                    if (result == Response.SendCommandNoHwdgResponse ||
-                        result == Response.SendCommandUnknownError ||
-                        result == Response.SendCommandPortBusy) continue;
-
-                    Trace.Write($" HWDG found at {portName} with status '{result}'");
-                    Trace.WriteLine($" at {Thread.CurrentThread.ManagedThreadId} thread");
-                    return result;
-                }
-
-                Trace.Write($"HWDG not found on any port. Exit with status '{result}'");
+                var response = searchPortBusy
+                    ? Response.SendCommandPortBusy
+                    : Response.SendCommandNoHwdgResponse;
+                Trace.Write($"HWDG not found on any port. Exit with status '{response}'");
                 Trace.WriteLine($" at {Thread.CurrentThread.ManagedThreadId} thread");
-                return result;
+                return response;
             }
+
             // In case we already know port name just send the command.
-            else
-            {
-                Trace.Write($"Trying to sent cmd at {lastSuccessedPortName}");
-                var result = SendCommand(lastSuccessedPortName, cmd);
-                Trace.WriteLine($"Cmd result {result}");
-                return result;
-            }
+            Trace.Write($"Trying to sent cmd at {lastSuccessedPortName}");
+            var result = SendCommand(lastSuccessedPortName, cmd);
+            Trace.WriteLine($"Cmd result {result}");
+            return result;
         }
 
         private Status GetStatus(String portName)
         {
-            const Int32 readStatusTimeout = 80;
-            const Int32 statusLength = 5;
-            const Int32 inputBufferOffset = 0;
-            const Byte getStatusCommand = 0x01;
+            Trace.WriteLine($"Getting status from {portName} at {Thread.CurrentThread.ManagedThreadId} thread");
+            var probe = ProbeStatusAsync(portName, ReadStatusTimeout).GetAwaiter().GetResult();
 
-            // Trying to open port and get status.
-            using (var port = new SerialPort(portName, Baudrate))
+            // No status or invalid status means transmission has failed.
+            // So we need to set last succeeded port name to NULL.
+            if (probe.Status == null)
             {
-                try
-                {
-                    Trace.WriteLine($"Getting status from {portName} at {Thread.CurrentThread.ManagedThreadId} thread");
-                    WriteToPort(port, getStatusCommand);
-
-                    // Wait until we get all bytes of response
-                    using (var source = new CancellationTokenSource(readStatusTimeout))
-                    {
-                        while (port.BytesToRead < statusLength && !source.IsCancellationRequested)
-                        {
-                        }
-                    }
-
-                    // Check that we received all bytes.
-                    if (port.BytesToRead != statusLength)
-                    {
-                        Trace.WriteLine($"No HWDG found on {portName} port");
-                        TransmissionFailed();
-                        return null;
-                    }
-
-                    //Read received data.
-                    var b = new Byte[statusLength];
-                    port.Read(b, inputBufferOffset, statusLength);
-
-                    // Verify checksum.
-                    var checksum = b.CalcCrc7(statusLength - 1);
-                    if (checksum != b[statusLength - 1])
-                    {
-                        Trace.Write("Checksum verification error.");
-                        Trace.WriteLine($"Calculated: {checksum}. Received: {b[statusLength - 1]}");
-                        TransmissionFailed();
-                        return null;
-                    }
-                    Trace.WriteLine($"Checksum verification ok. at {Thread.CurrentThread.ManagedThreadId} thread");
-
-                    // If there is no exceptions during writing and reading that
-                    // means HWDG is present on current port and responses. Update
-                    // last successful connection port name if necessary.
-                    Trace.WriteLine($"Reading response {b[0]:X2} {b[1]:X2} {b[2]:X2} {b[3]:X2} {b[4]:X2} OK!");
-                    TransmissionOk(port.PortName);
-                    return new Status(b);
-                }
-                // If any exception occurred that means transmission has failed.
-                // So we need to set last succeeded port name to NULL.
-                // Set lastSuccessedPortName to NULL if necessary.
-                catch (Exception ex)
-                {
-                    Trace.Write($"Get status fail at {Thread.CurrentThread.ManagedThreadId} thread! ");
-                    Trace.WriteLine($"Reason: {ex.Message}");
-                    TransmissionFailed();
-                    return null;
-                }
+                searchPortBusy |= probe.IsBusy;
+                TransmissionFailed();
+                return null;
             }
+
+            // HWDG is present on current port and responses. Update
+            // last successful connection port name if necessary.
+            TransmissionOk(portName);
+            return probe.Status;
         }
 
         private Response SendCommand(String portName, Byte cmd)
@@ -299,15 +331,8 @@ namespace HwdgWrapper
                     WriteToPort(port, cmd);
 
                     // Wait until we get all bytes of response
-                    using (var source = new CancellationTokenSource(readCmdResponseTimeout))
-                    {
-                        while (port.BytesToRead < cmdResponseLength && !source.IsCancellationRequested)
-                        {
-                        }
-                    }
-
-                    // Check that we received all bytes.
-                    if (port.BytesToRead != cmdResponseLength)
+                    var b = new Byte[cmdResponseLength];
+                    if (!ReadAsync(port, b, readCmdResponseTimeout).GetAwaiter().GetResult())
                     {
                         Trace.Write($"No HWDG found on {portName} port ");
                         Trace.WriteLine($"at {Thread.CurrentThread.ManagedThreadId} thread");
@@ -315,7 +340,7 @@ namespace HwdgWrapper
                         return Response.SendCommandNoHwdgResponse;
                     }
 
-                    var rsp = (Response) port.ReadByte();
+                    var rsp = (Response) b[0];
 
                     // If there is no exceptions during writing and reading that
                     // means HWDG is present on current port and responses. Update
@@ -345,6 +370,155 @@ namespace HwdgWrapper
             }
         }
 
+        private void SendCommands(String portName, Byte[] cmds, Int32 window, Response[] result)
+        {
+            const Int32 readCmdResponseTimeout = 50;
+            const Byte tagNextCommand = 0x0D;
+            const Byte eventMarker = 0xA5;
+            const Int32 eventFrameTail = 3;
+
+            // Trying to open port and send the commands.
+            using (var port = new SerialPort(portName, Baudrate))
+            {
+                try
+                {
+                    port.ReadTimeout = readCmdResponseTimeout;
+                    port.WriteTimeout = readCmdResponseTimeout;
+                    port.Open();
+
+                    // Tag is command index modulo 256, window never exceeds 256
+                    // commands, so tags of commands in flight are unique.
+                    var inFlight = new Dictionary<Byte, Int32>();
+                    var sent = 0;
+                    while (sent < cmds.Length || inFlight.Count > 0)
+                    {
+                        while (sent < cmds.Length && inFlight.Count < window)
+                        {
+                            var tag = (Byte) sent;
+                            port.Write(new[] {tagNextCommand, tag, cmds[sent]}, 0, 3);
+                            inFlight[tag] = sent++;
+                        }
+
+                        // Skip events that may come between responses.
+                        var b = port.ReadByte();
+                        if (b == eventMarker)
+                        {
+                            for (var i = 0; i < eventFrameTail; i++) port.ReadByte();
+                            continue;
+                        }
+                        if (b != (Byte) Response.TaggedResponse) continue;
+
+                        var rspTag = (Byte) port.ReadByte();
+                        var rsp = (Response) port.ReadByte();
+                        if (!inFlight.TryGetValue(rspTag, out var index)) continue;
+                        inFlight.Remove(rspTag);
+                        result[index] = rsp;
+                    }
+
+                    Trace.WriteLine($"{cmds.Length} tagged commands OK! at {Thread.CurrentThread.ManagedThreadId} thread");
+                    TransmissionOk(portName);
+                }
+
+                // Timeout means some command got no response, the rest keep their results.
+                catch (Exception ex)
+                {
+                    Trace.Write($"Send commands fail! Reason: {ex.Message}. ");
+                    Trace.WriteLine($"at {Thread.CurrentThread.ManagedThreadId} thread");
+                    TransmissionFailed();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets status from the port without touching connection state,
+        /// so several ports can be probed at once.
+        /// </summary>
+        /// <param name="portName">Port to be probed.</param>
+        /// <param name="timeout">Time to wait for the whole response, ms.</param>
+        /// <returns>Returns probe result, its Status is null if no valid status received.</returns>
+        private static async Task<ProbeResult> ProbeStatusAsync(String portName, Int32 timeout)
+        {
+            var result = new ProbeResult {PortName = portName};
+            var stopwatch = Stopwatch.StartNew();
+            using (var port = new SerialPort(portName, Baudrate))
+            {
+                try
+                {
+                    WriteToPort(port, GetStatusCommand);
+                    var b = new Byte[StatusLength];
+                    if (!await ReadAsync(port, b, timeout).ConfigureAwait(false))
+                    {
+                        Trace.WriteLine($"No HWDG found on {portName} port");
+                        return result;
+                    }
+                    result.Elapsed = stopwatch.Elapsed;
+
+                    // Verify checksum.
+                    var checksum = b.CalcCrc7(StatusLength - 1);
+                    if (checksum != b[StatusLength - 1])
+                    {
+                        Trace.Write($"Checksum verification error on {portName} port. ");
+                        Trace.WriteLine($"Calculated: {checksum}. Received: {b[StatusLength - 1]}");
+                        return result;
+                    }
+                    Trace.WriteLine($"Reading response {b[0]:X2} {b[1]:X2} {b[2]:X2} {b[3]:X2} {b[4]:X2} OK!");
+                    result.Status = new Status(b);
+                }
+                catch (Exception ex)
+                {
+                    Trace.WriteLine($"Probe {portName} fail! Hr:{ex.HResult:X2} Reason: {ex.Message}");
+                    result.IsBusy = (UInt32) ex.HResult == 0x80070005;
+                }
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Reads exactly buffer length bytes. The thread sleeps until the driver
+        /// signals data arrival or the deadline passes, so no CPU is spent on waiting.
+        /// </summary>
+        /// <param name="port">Opened port.</param>
+        /// <param name="buffer">Buffer to be filled.</param>
+        /// <param name="timeout">Time to wait for all bytes, ms.</param>
+        /// <returns>Returns false if bytes did not arrive in time.</returns>
+        private static async Task<Boolean> ReadAsync(SerialPort port, Byte[] buffer, Int32 timeout)
+        {
+            var deadline = Task.Delay(timeout);
+            var offset = 0;
+            while (offset < buffer.Length && !deadline.IsCompleted)
+            {
+                var read = port.BaseStream.ReadAsync(buffer, offset, buffer.Length - offset);
+                if (await Task.WhenAny(read, deadline).ConfigureAwait(false) == deadline)
+                {
+                    // Read is aborted when port gets closed, observe its exception.
+                    _ = read.ContinueWith(t => t.Exception, TaskContinuationOptions.OnlyOnFaulted);
+                    return false;
+                }
+
+                // Port ReadTimeout may end the read with no data before
+                // the deadline, keep waiting in that case. Read completed
+                // with no data means the port is gone, no more bytes come.
+                try
+                {
+                    var count = await read.ConfigureAwait(false);
+                    if (count == 0) return false;
+                    offset += count;
+                }
+                catch (TimeoutException)
+                {
+                }
+            }
+            return offset == buffer.Length;
+        }
+
+        private sealed class ProbeResult
+        {
+            public String PortName;
+            public Status Status;
+            public TimeSpan Elapsed;
+            public Boolean IsBusy;
+        }
+
         /// <summary>
         /// This procedure calls in case of successful transmission.
         /// </summary>